@@ -36,6 +36,11 @@ Type toType(std::string str) {
   return Type::AUTO;
 }
 
+size_t blockFrames() {
+  const float frames = Config::options.audio.sample_rate * Config::options.audio.latency / 1000.0f;
+  return std::clamp(static_cast<size_t>(frames), static_cast<size_t>(32), DSP::bufferSize / 4);
+}
+
 namespace Pulseaudio {
 #if HAVE_PULSEAUDIO
 
@@ -165,13 +170,8 @@ void init() {
   sampleSpec.rate = Config::options.audio.sample_rate;
   sampleSpec.channels = 2;
 
-  // Calculate buffer size based on FPS
-  uint32_t samples = 0;
-  try {
-    samples = static_cast<uint32_t>(sampleSpec.rate / Config::options.window.fps_limit);
-  } catch (...) {
-    samples = 512;
-  }
+  // Calculate buffer size based on the latency target
+  uint32_t samples = static_cast<uint32_t>(blockFrames());
 
   const uint32_t bytesPerSample = sampleSpec.channels * sizeof(float);
   const uint32_t bufferSize = samples * bytesPerSample;
@@ -225,15 +225,15 @@ bool read(float* buffer, const size_t& samples) {
 bool reconfigure() {
   static std::string lastDevice = "";
   static uint32_t lastSampleRate = 0;
-  static size_t lastFPS = 0;
+  static float lastLatency = 0;
 
   // Check if reconfiguration is needed
-  if (lastDevice == Config::options.audio.device && lastFPS == Config::options.window.fps_limit &&
+  if (lastDevice == Config::options.audio.device && lastLatency == Config::options.audio.latency &&
       lastSampleRate == Config::options.audio.sample_rate) [[likely]]
     return false;
 
   lastSampleRate = Config::options.audio.sample_rate;
-  lastFPS = Config::options.window.fps_limit;
+  lastLatency = Config::options.audio.latency;
   lastDevice = Config::options.audio.device;
 
   init();
@@ -269,7 +269,8 @@ struct pw_stream* stream;
 struct spa_hook streamListener;
 struct pw_registry* registry;
 struct spa_hook registryListener;
-std::binary_semaphore readSem {0};
+Wakeup readWake;
+DSP::StagingRing staging;
 
 bool initialized = false;
 bool running = false;
@@ -328,53 +329,18 @@ void onProcess(void*) {
     return;
   }
 
-  // Process audio data
+  // Only copy the interleaved frames here, conversion happens on the DSP thread in read()
   float* samples = static_cast<float*>(buf->datas[0].data);
   size_t n_samples = buf->datas[0].chunk->size / sizeof(float);
 
   if (n_samples > buf->datas[0].maxsize / sizeof(float))
     n_samples = buf->datas[0].maxsize / sizeof(float);
 
-  float gain = powf(10.0f, Config::options.audio.gain_db / 20.0f);
-
-  // Process samples with SIMD optimization if available
-#ifdef HAVE_AVX2
-  size_t simd_samples = n_samples & ~7;
-  __m256i left_idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
-  __m256i right_idx = _mm256_setr_epi32(1, 3, 5, 7, 0, 0, 0, 0);
-
-  for (size_t i = 0; i < simd_samples; i += 8) {
-    __m256 data = _mm256_loadu_ps(&samples[i]);
-
-    __m256 left = _mm256_permutevar8x32_ps(data, left_idx);
-    __m256 right = _mm256_permutevar8x32_ps(data, right_idx);
-
-    __m256 vGain = _mm256_set1_ps(gain);
-    left = _mm256_mul_ps(left, vGain);
-    right = _mm256_mul_ps(right, vGain);
-
-    __m256 mid = _mm256_mul_ps(_mm256_add_ps(left, right), _mm256_set1_ps(0.5f));
-    __m256 side = _mm256_mul_ps(_mm256_sub_ps(left, right), _mm256_set1_ps(0.5f));
-
-    _mm_storeu_ps(&DSP::bufferMid[DSP::writePos], _mm256_castps256_ps128(mid));
-    _mm_storeu_ps(&DSP::bufferSide[DSP::writePos], _mm256_castps256_ps128(side));
-    DSP::writePos = (DSP::writePos + 4) % DSP::bufferSize;
-  }
-
-  for (size_t i = simd_samples; i + 1 < n_samples; i += 2) {
-#else
-  for (size_t i = 0; i + 1 < n_samples; i += 2) {
-#endif
-    float left = samples[i] * gain;
-    float right = samples[i + 1] * gain;
-    DSP::bufferMid[DSP::writePos] = (left + right) / 2.0f;
-    DSP::bufferSide[DSP::writePos] = (left - right) / 2.0f;
-    DSP::writePos = (DSP::writePos + 1) % DSP::bufferSize;
-  }
+  staging.write(samples, n_samples / 2);
 
   pw_stream_queue_buffer(stream, b);
 
-  readSem.release();
+  readWake.notify();
 }
 
 std::pair<std::string, uint32_t> find(std::string dev) {
@@ -438,6 +404,10 @@ void init() {
   if (initialized)
     cleanup();
 
+  // The stream is torn down at this point, so the staging ring can be (re)allocated safely
+  if (staging.capacity() == 0)
+    staging.resize(DSP::bufferSize);
+
   pw_init(nullptr, nullptr);
 
   // Create PipeWire thread loop
@@ -493,8 +463,8 @@ void init() {
 
   pw_thread_loop_lock(loop);
 
-  // Calculate buffer size
-  size_t samples = info.rate / Config::options.window.fps_limit;
+  // Calculate buffer size based on the latency target
+  size_t samples = blockFrames();
 
   std::string nodeLatency = std::to_string(samples) + "/" + std::to_string(info.rate);
 
@@ -538,23 +508,42 @@ void init() {
   initialized = true;
 }
 
-bool read(float*, const size_t&) {
-  // Wait for up to 100ms
-  return readSem.try_acquire_for(std::chrono::milliseconds(100));
+bool read(float*, const size_t& frames) {
+  // Wait until a full block is staged, for up to 100ms
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  while (staging.pending() < frames) {
+    if (!readWake.waitUntil(deadline))
+      break;
+  }
+
+  // Convert everything the realtime callback staged since the last read in one batch
+  float gain = powf(10.0f, Config::options.audio.gain_db / 20.0f);
+  size_t consumed =
+      staging.consume([gain](const float* samples, size_t frames) { DSP::pushInterleaved(samples, frames, gain); });
+  if (consumed == 0)
+    return false;
+
+  static uint64_t lastOverruns = 0;
+  if (staging.overruns() != lastOverruns) {
+    logDebug("PipeWire staging ring overran, {} frames dropped", staging.overruns() - lastOverruns);
+    lastOverruns = staging.overruns();
+  }
+
+  return true;
 }
 
 bool reconfigure() {
   static std::string lastDevice = "";
   static uint32_t lastSampleRate = 0;
-  static size_t lastFPS = 0;
+  static float lastLatency = 0;
 
   // Check if reconfiguration is needed
-  if (lastDevice == Config::options.audio.device && lastFPS == Config::options.window.fps_limit &&
+  if (lastDevice == Config::options.audio.device && lastLatency == Config::options.audio.latency &&
       lastSampleRate == Config::options.audio.sample_rate) [[likely]]
     return false;
 
   lastSampleRate = Config::options.audio.sample_rate;
-  lastFPS = Config::options.window.fps_limit;
+  lastLatency = Config::options.audio.latency;
   lastDevice = Config::options.audio.device;
 
   init();
@@ -591,7 +580,7 @@ UINT32 bufferFrameCount;
 
 bool initialized = false;
 bool running = false;
-std::binary_semaphore readSem {0};
+Wakeup readWake;
 
 std::thread wasapiThread;
 
@@ -620,52 +609,13 @@ void threadFunc() {
       if (SUCCEEDED(hr)) {
         // Process audio data
         float* samples = reinterpret_cast<float*>(pData);
-        size_t n_samples = numFrames * 2;
 
         if (flags & AUDCLNT_BUFFERFLAGS_SILENT) {
           // If the buffer is silent, skip processing and just write zeros
-          for (size_t i = 0; i + 1 < n_samples; i += 2) {
-            DSP::bufferMid[DSP::writePos] = 0.f;
-            DSP::bufferSide[DSP::writePos] = 0.f;
-            DSP::writePos = (DSP::writePos + 1) % DSP::bufferSize;
-          }
+          DSP::ring.fill(numFrames);
         } else {
           float gain = powf(10.0f, Config::options.audio.gain_db / 20.0f);
-
-          // Process samples with SIMD optimization if available
-#ifdef HAVE_AVX2
-          size_t simd_samples = n_samples & ~7;
-          __m256i left_idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
-          __m256i right_idx = _mm256_setr_epi32(1, 3, 5, 7, 0, 0, 0, 0);
-
-          for (size_t i = 0; i < simd_samples; i += 8) {
-            __m256 data = _mm256_loadu_ps(&samples[i]);
-
-            __m256 left = _mm256_permutevar8x32_ps(data, left_idx);
-            __m256 right = _mm256_permutevar8x32_ps(data, right_idx);
-
-            __m256 vGain = _mm256_set1_ps(gain);
-            left = _mm256_mul_ps(left, vGain);
-            right = _mm256_mul_ps(right, vGain);
-
-            __m256 mid = _mm256_mul_ps(_mm256_add_ps(left, right), _mm256_set1_ps(0.5f));
-            __m256 side = _mm256_mul_ps(_mm256_sub_ps(left, right), _mm256_set1_ps(0.5f));
-
-            _mm_storeu_ps(&DSP::bufferMid[DSP::writePos], _mm256_castps256_ps128(mid));
-            _mm_storeu_ps(&DSP::bufferSide[DSP::writePos], _mm256_castps256_ps128(side));
-            DSP::writePos = (DSP::writePos + 4) % DSP::bufferSize;
-          }
-
-          for (size_t i = simd_samples; i + 1 < n_samples; i += 2) {
-#else
-          for (size_t i = 0; i + 1 < n_samples; i += 2) {
-#endif
-            float left = samples[i] * gain;
-            float right = samples[i + 1] * gain;
-            DSP::bufferMid[DSP::writePos] = (left + right) / 2.0f;
-            DSP::bufferSide[DSP::writePos] = (left - right) / 2.0f;
-            DSP::writePos = (DSP::writePos + 1) % DSP::bufferSize;
-          }
+          DSP::pushInterleaved(samples, numFrames, gain);
         }
 
         captureClient->ReleaseBuffer(numFrames);
@@ -673,7 +623,7 @@ void threadFunc() {
 
       captureClient->GetNextPacketSize(&packetSize);
 
-      readSem.release();
+      readWake.notify();
     }
   }
 }
@@ -898,7 +848,7 @@ void init() {
 
   // I don't think WASAPI cares about ^2 sample counts
   // we don't have much influence over the buffer size anyways
-  size_t targetSamples = wfx->nSamplesPerSec / Config::options.window.fps_limit;
+  size_t targetSamples = std::max<size_t>(1, wfx->nSamplesPerSec * Config::options.audio.latency / 1000.0f);
   REFERENCE_TIME hnsBufferDuration = (REFERENCE_TIME)(1e7 * targetSamples / wfx->nSamplesPerSec);
 
   // Create the audio client
@@ -945,21 +895,21 @@ void init() {
 
 bool read(float*, const size_t&) {
   // Wait for up to 100ms
-  return readSem.try_acquire_for(std::chrono::milliseconds(100));
+  return readWake.waitFor(std::chrono::milliseconds(100));
 }
 
 bool reconfigure() {
   static std::string lastDevice = "";
   static uint32_t lastSampleRate = 0;
-  static size_t lastFPS = 0;
+  static float lastLatency = 0;
 
   // Check if reconfiguration is needed
-  if (lastDevice == Config::options.audio.device && lastFPS == Config::options.window.fps_limit &&
+  if (lastDevice == Config::options.audio.device && lastLatency == Config::options.audio.latency &&
       lastSampleRate == Config::options.audio.sample_rate) [[likely]]
     return false;
 
   lastSampleRate = Config::options.audio.sample_rate;
-  lastFPS = Config::options.window.fps_limit;
+  lastLatency = Config::options.audio.latency;
   lastDevice = Config::options.audio.device;
 
   init();
@@ -27,9 +27,8 @@
 
 namespace DSP {
 
-// Audio buffer data with SIMD alignment
-std::vector<float, AlignedAllocator<float, 32>> bufferMid;
-std::vector<float, AlignedAllocator<float, 32>> bufferSide;
+// Audio sample ring and filtered copies with SIMD alignment
+RingBuffer ring;
 std::vector<float, AlignedAllocator<float, 32>> bandpassed;
 std::vector<float, AlignedAllocator<float, 32>> lowpassed;
 
@@ -42,10 +41,7 @@ std::vector<float> fftSide;
 std::vector<float> fftSidePhase;
 
 const size_t bufferSize = 32768;
-size_t writePos = 0;
 
-// Pitch detection variables
-float pitch;
 float pitchDB;
 
 std::tuple<std::string, int, int> toNote(float freq, std::string* noteNames) {
@@ -64,72 +60,200 @@ std::tuple<std::string, int, int> toNote(float freq, std::string* noteNames) {
                          static_cast<int>(std::round((midi - static_cast<float>(roundedMidi)) * 100.f)));
 }
 
+void pushInterleaved(const float* samples, size_t frames, float gain) {
+  ring.produce(frames, [samples, gain](float* mid, float* side, size_t offset, size_t len) {
+    const float* src = samples + offset * 2;
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    __m256 vGain = _mm256_set1_ps(0.5f * gain);
+
+    // 8 frames per iteration: split two interleaved vectors into full 8-wide L/R vectors
+    for (; i + 8 <= len; i += 8) {
+      __m256 a = _mm256_loadu_ps(&src[i * 2]);
+      __m256 b = _mm256_loadu_ps(&src[i * 2 + 8]);
+
+      // Per 128-bit lane: L0 L1 L4 L5 | L2 L3 L6 L7, then restore order across lanes
+      __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+      left = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(left), _MM_SHUFFLE(3, 1, 2, 0)));
+      right = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(right), _MM_SHUFFLE(3, 1, 2, 0)));
+
+      _mm256_storeu_ps(&mid[i], _mm256_mul_ps(_mm256_add_ps(left, right), vGain));
+      _mm256_storeu_ps(&side[i], _mm256_mul_ps(_mm256_sub_ps(left, right), vGain));
+    }
+#endif
+    for (; i < len; i++) {
+      float left = src[i * 2] * gain;
+      float right = src[i * 2 + 1] * gain;
+      mid[i] = (left + right) / 2.f;
+      side[i] = (left - right) / 2.f;
+    }
+  });
+}
+
+/**
+ * @brief Write gainMid * mid + gainSide * side for a span of the ring, optionally multiplied by a window
+ */
+template <bool Windowed>
+void mixSpan(const RingBuffer::Span& span, float gainMid, float gainSide, const float* win, float* out) {
+  ring.read(span, [=](const float* mid, const float* side, size_t offset, size_t len) {
+    const float* w = Windowed ? win + offset : nullptr;
+    float* dst = out + offset;
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    const __m256 vGainMid = _mm256_set1_ps(gainMid);
+    const __m256 vGainSide = _mm256_set1_ps(gainSide);
+    for (; i + 8 <= len; i += 8) {
+      __m256 x = _mm256_fmadd_ps(_mm256_loadu_ps(side + i), vGainSide,
+                                 _mm256_mul_ps(_mm256_loadu_ps(mid + i), vGainMid));
+      if constexpr (Windowed)
+        x = _mm256_mul_ps(x, _mm256_loadu_ps(w + i));
+      _mm256_storeu_ps(dst + i, x);
+    }
+#endif
+    for (; i < len; i++) {
+      float x = mid[i] * gainMid + side[i] * gainSide;
+      if constexpr (Windowed)
+        x *= w[i];
+      dst[i] = x;
+    }
+  });
+}
+
 namespace FIR {
 
 Filter bandpass_filter;
 
-float Filter::process(float x) {
-  const size_t nTaps = coeffs.size();
-  if (nTaps == 0)
-    return x;
-  idx %= nTaps;
-  delay[idx] = x;
+// Overlap-save buffers and transforms; mutex only guards them against cleanup()
+std::mutex mutex;
+float* input = nullptr;
+float* output = nullptr;
+float* faded = nullptr;
+fftwf_complex* spectrum = nullptr;
+fftwf_complex* product = nullptr;
+fftwf_plan forward = nullptr;
+fftwf_plan inverse = nullptr;
 
-  float out = 0.0f;
+void init() {
+  std::lock_guard<std::mutex> lockFir(mutex);
+  input = fftwf_alloc_real(blockSize);
+  output = fftwf_alloc_real(blockSize);
+  faded = fftwf_alloc_real(blockSize);
+  spectrum = fftwf_alloc_complex(blockSize / 2 + 1);
+  product = fftwf_alloc_complex(blockSize / 2 + 1);
+  if (input && output && faded && spectrum && product) {
+    std::lock_guard<std::mutex> lock(FFT::plannerMutex);
+    forward = fftwf_plan_dft_r2c_1d(blockSize, input, spectrum, FFTW_ESTIMATE);
+    inverse = fftwf_plan_dft_c2r_1d(blockSize, product, output, FFTW_ESTIMATE);
+  }
+  if (!forward || !inverse)
+    logWarnAt(std::source_location::current(), "Failed to plan the band-pass filter");
+}
 
-#ifdef HAVE_AVX2
-  // Compute dot product without modulo by splitting into two contiguous segments:
-  // [idx .. end] then [0 .. idx-1]
-  const size_t firstLen = nTaps - idx;
-  const float* coeffPtr = coeffs.data();
-  const float* delayPtr1 = delay.data() + idx;
+void cleanup() {
+  std::lock_guard<std::mutex> lockFir(mutex);
+  {
+    std::lock_guard<std::mutex> lock(FFT::plannerMutex);
+    if (forward)
+      fftwf_destroy_plan(forward);
+    if (inverse)
+      fftwf_destroy_plan(inverse);
+  }
+  forward = inverse = nullptr;
+  for (float** buf : {&input, &output, &faded}) {
+    fftwf_free(*buf);
+    *buf = nullptr;
+  }
+  for (fftwf_complex** buf : {&spectrum, &product}) {
+    fftwf_free(*buf);
+    *buf = nullptr;
+  }
+}
 
-  size_t n = 0;
-  __m256 sumVec = _mm256_setzero_ps();
-  for (; n + 7 < firstLen; n += 8) {
-    __m256 c = _mm256_loadu_ps(coeffPtr + n);
-    __m256 d = _mm256_loadu_ps(delayPtr1 + n);
-    sumVec = _mm256_fmadd_ps(c, d, sumVec);
-  }
-  out += avx2_reduce_add_ps(sumVec);
-  for (; n < firstLen; ++n)
-    out += coeffPtr[n] * delayPtr1[n];
-
-  // Second contiguous segment
-  const size_t secondLen = idx;
-  const float* delayPtr2 = delay.data();
-  sumVec = _mm256_setzero_ps();
-  size_t k = 0;
-  for (; k + 7 < secondLen; k += 8) {
-    __m256 c = _mm256_loadu_ps(coeffPtr + firstLen + k);
-    __m256 d = _mm256_loadu_ps(delayPtr2 + k);
-    sumVec = _mm256_fmadd_ps(c, d, sumVec);
-  }
-  out += avx2_reduce_add_ps(sumVec);
-  for (; k < secondLen; ++k)
-    out += coeffPtr[firstLen + k] * delayPtr2[k];
-#else
-  // Fallback scalar path
-  const size_t firstLen = nTaps - idx;
-  for (size_t i = 0; i < firstLen; ++i)
-    out += coeffs[i] * delay[idx + i];
-  for (size_t i = 0; i < idx; ++i)
-    out += coeffs[firstLen + i] * delay[i];
-#endif
+void Filter::process(RingBuffer::Span span, float* out) {
+  const size_t taps = coeffs.size();
+  if (taps == 0 || !forward || !inverse) {
+    std::fill_n(out, span.count, 0.0f);
+    return;
+  }
+
+  // Multiply the input spectrum by a response and transform back into dst
+  auto convolve = [](const std::vector<std::complex<float>>& h, float* dst) {
+    for (size_t k = 0; k < h.size(); ++k) {
+      product[k][0] = spectrum[k][0] * h[k].real() - spectrum[k][1] * h[k].imag();
+      product[k][1] = spectrum[k][0] * h[k].imag() + spectrum[k][1] * h[k].real();
+    }
+    fftwf_execute_dft_c2r(inverse, product, dst);
+  };
 
-  idx = (idx + 1) % nTaps;
-  return out;
+  const size_t step = blockSize - taps + 1;
+  for (size_t done = 0; done < span.count;) {
+    const size_t count = std::min(step, span.count - done);
+
+    // The newest count outputs of a circular convolution over the blockSize frames ending here are free of
+    // wrap-around, so the ring itself provides the overlap. Frames before the start of the stream are silence.
+    const uint64_t end = span.begin + done + count;
+    const size_t history = static_cast<size_t>(std::min<uint64_t>(end, blockSize));
+    std::fill_n(input, blockSize - history, 0.0f);
+    if (!ring.copy(ring.latest(end, history), input + blockSize - history, nullptr)) {
+      // The producer lapped us, these frames are gone; the crossfade runs on through the silence
+      std::fill_n(out + done, count, 0.0f);
+      fade -= std::min(fade, count);
+      done += count;
+      continue;
+    }
+    fftwf_execute_dft_r2c(forward, input, spectrum);
+    convolve(response, output);
+    const float* current = output + blockSize - count;
+
+    if (fade > 0) {
+      // Filtering is linear in the coefficients, so blending outputs equals filtering with blended coefficients
+      convolve(previous, faded);
+      const float* old = faded + blockSize - count;
+      const size_t fading = std::min(fade, count);
+      for (size_t i = 0; i < fading; ++i) {
+        const float t = static_cast<float>(fade - i) / static_cast<float>(crossfadeSamples);
+        out[done + i] = current[i] + t * (old[i] - current[i]);
+      }
+      std::copy_n(current + fading, count - fading, out + done + fading);
+      fade -= fading;
+    } else {
+      std::copy_n(current, count, out + done);
+    }
+    done += count;
+  }
 }
 
 void Filter::set_coefficients(const std::vector<float>& coeffs) {
+  if (!forward || coeffs.empty() || coeffs.size() > maxTaps)
+    return;
+
+  // Spectrum of the zero-padded coefficients, including the 1 / blockSize of the unnormalized inverse
+  std::fill_n(input, blockSize, 0.0f);
+  std::copy(coeffs.begin(), coeffs.end(), input);
+  fftwf_execute_dft_r2c(forward, input, spectrum);
+  std::vector<std::complex<float>> next(blockSize / 2 + 1);
+  const float scale = 1.0f / static_cast<float>(blockSize);
+  for (size_t k = 0; k < next.size(); ++k)
+    next[k] = {spectrum[k][0] * scale, spectrum[k][1] * scale};
+
   if (coeffs.size() == this->coeffs.size()) {
-    this->coeffs = coeffs;
+    // Fade out from what is audible right now, which mid-fade is the blend of both sets
+    if (fade > 0) {
+      const float t = static_cast<float>(fade) / static_cast<float>(crossfadeSamples);
+      for (size_t k = 0; k < previous.size(); ++k)
+        previous[k] = response[k] + t * (previous[k] - response[k]);
+    } else {
+      previous = response;
+    }
+    fade = crossfadeSamples;
   } else {
-    this->coeffs.resize(coeffs.size());
-    this->coeffs = coeffs;
+    previous.clear();
+    fade = 0;
     order = coeffs.size() - 1;
-    delay.resize(coeffs.size(), 0.0f);
   }
+  this->coeffs = coeffs;
+  response = std::move(next);
 }
 
 // Modified Bessel function of the first kind, order 0 (I0)
@@ -167,16 +291,19 @@ std::vector<float> kaiser_window(size_t length, float beta) {
   return window;
 }
 
-void design(float center) {
-  float bw = Config::options.oscilloscope.bandpass.bandwidth;
+// Designs by quantized center (see designCents) and Kaiser windows by length, valid for the settings in design()
+std::unordered_map<int, std::vector<float>> designs;
+std::unordered_map<size_t, std::vector<float>> windows;
 
+/**
+ * @brief Windowed-sinc band-pass design for one center frequency
+ */
+static std::vector<float> designFor(float center, float bw, float sidelobe, float fs) {
   // Kaiser window with beta chosen for ~60 dB sidelobe attenuation
-  float sidelobe = Config::options.oscilloscope.bandpass.sidelobe;
   float beta = sidelobe < 21.0f   ? 0.0f
                : sidelobe < 50.0f ? 0.5842f * powf(sidelobe - 21.0f, 0.4f) + 0.07886f * (sidelobe - 21.0f)
                                   : 0.1102f * (sidelobe - 8.7f);
 
-  float fs = Config::options.audio.sample_rate;
   float wc1 = 2.0f * M_PI * (center - bw / 2.0f) / fs;
   float wc2 = 2.0f * M_PI * (center + bw / 2.0f) / fs;
   wc1 = std::max(wc1, 0.001f);
@@ -190,22 +317,26 @@ void design(float center) {
 
   size_t len = order + 1;
   size_t center_tap = len / 2;
-  std::vector<float> ideal(len);
+
+  // The order only depends on the settings away from the band edges, so windows are shared across centers
+  auto found = windows.find(len);
+  if (found == windows.end())
+    found = windows.emplace(len, kaiser_window(len, beta)).first;
+  const std::vector<float>& window = found->second;
+
+  std::vector<float> windowed(len);
   for (size_t i = 0; i < len; ++i) {
+    float ideal;
     if (i == center_tap) {
-      ideal[i] = (wc2 - wc1) / M_PI;
+      ideal = (wc2 - wc1) / M_PI;
     } else {
       float n = static_cast<float>(static_cast<int>(i) - static_cast<int>(center_tap));
-      ideal[i] = (sinf(wc2 * n) - sinf(wc1 * n)) / (M_PI * n);
+      ideal = (sinf(wc2 * n) - sinf(wc1 * n)) / (M_PI * n);
     }
-  }
-  std::vector<float> window = kaiser_window(len, beta);
-  std::vector<float> windowed(len);
-  for (size_t i = 0; i < len; ++i) {
-    windowed[i] = ideal[i] * window[i];
+    windowed[i] = ideal * window[i];
   }
 
-  float center_freq = 2.0f * M_PI * center / Config::options.audio.sample_rate;
+  float center_freq = 2.0f * M_PI * center / fs;
   float response_at_center = 0.0f;
   for (size_t i = 0; i < len; ++i) {
     response_at_center += windowed[i] * cosf(center_freq * (static_cast<float>(i) - static_cast<float>(center_tap)));
@@ -217,48 +348,88 @@ void design(float center) {
       coeff *= scale_factor;
     }
   }
-  bandpass_filter.set_coefficients(windowed);
+  return windowed;
 }
 
-void process(float center) {
-  design(center);
-  static size_t lastWritePos = 0;
-  if (lastWritePos == writePos)
+void design(float center) {
+  const float bw = Config::options.oscilloscope.bandpass.bandwidth;
+  const float sidelobe = Config::options.oscilloscope.bandpass.sidelobe;
+  const float fs = Config::options.audio.sample_rate;
+
+  // Cached designs are only valid for the settings they were built with
+  static float lastBw = -1.0f;
+  static float lastSidelobe = -1.0f;
+  static float lastFs = -1.0f;
+  if (bw != lastBw || sidelobe != lastSidelobe || fs != lastFs || designs.size() >= maxDesigns) {
+    designs.clear();
+    if (bw != lastBw || sidelobe != lastSidelobe || fs != lastFs)
+      windows.clear();
+    lastBw = bw;
+    lastSidelobe = sidelobe;
+    lastFs = fs;
+  }
+
+  // Snap to the quantization grid so every center in a bucket shares one design
+  static std::optional<int> lastKey;
+  const int key = static_cast<int>(std::lround(1200.0f * log2f(center / 440.0f) / designCents));
+  auto found = designs.find(key);
+  if (found == designs.end()) {
+    const float snapped = 440.0f * exp2f(static_cast<float>(key) * designCents / 1200.0f);
+    found = designs.emplace(key, designFor(snapped, bw, sidelobe, fs)).first;
+  } else if (lastKey == key && bandpass_filter.coeffs.size() == found->second.size()) {
     return;
-  size_t count = (writePos - lastWritePos) % bufferSize;
-  for (size_t i = 0; i < count; i++) {
-    size_t readIdx = (lastWritePos + i + bufferSize) % bufferSize;
-    float input = bufferMid[readIdx];
-    float filtered = bandpass_filter.process(input);
-    bandpassed[(readIdx - bandpass_filter.order / 2 + bufferSize) % bufferSize] = filtered;
   }
-  lastWritePos = writePos;
+
+  lastKey = key;
+  bandpass_filter.set_coefficients(found->second);
+}
+
+void process(float center) {
+  std::lock_guard<std::mutex> lock(mutex);
+  design(center);
+  static RingBuffer::Reader reader;
+  static std::vector<float> block;
+  const RingBuffer::Span span = ring.poll(reader, bufferSize);
+  block.resize(span.count);
+  bandpass_filter.process(span, block.data());
+
+  // Store each output at the frame it describes, undoing the order / 2 group delay
+  const size_t delay = bandpass_filter.order / 2;
+  for (size_t i = 0; i < span.count; i++)
+    bandpassed[ring.index(span.begin + i - delay)] = block[i];
 }
 
 } // namespace FIR
 
 namespace Lowpass {
-struct Biquad {
-  float b0, b1, b2, a1, a2;
-  float x1, x2, y1, y2;
-  float process(float x) {
-    float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
-    x2 = x1;
-    x1 = x;
-    y2 = y1;
-    y1 = y;
-    return y;
-  }
-  void reset() { x1 = x2 = y1 = y2 = 0.0f; }
+
+/**
+ * @brief Cascade of Butterworth sections in transposed direct form II, one SIMD lane per section.
+ *
+ * The cascade is skewed in time: at each step lane k filters the sample lane k - 1 produced on the
+ * previous step, so every section advances at once and the last section's output trails the input by
+ * sections - 1 samples. Unused lanes have zero coefficients.
+ */
+struct Cascade {
+  alignas(32) float b0[maxSections] = {};
+  alignas(32) float b1[maxSections] = {};
+  alignas(32) float b2[maxSections] = {};
+  alignas(32) float a1[maxSections] = {};
+  alignas(32) float a2[maxSections] = {};
+  alignas(32) float s1[maxSections] = {};
+  alignas(32) float s2[maxSections] = {};
+  alignas(32) float y[maxSections] = {};
+  size_t sections = 0;
 };
-std::vector<Biquad> biquads;
+Cascade cascade;
 
 void init() {
-  biquads.clear();
-  int sections = Config::options.oscilloscope.lowpass.order / 2;
+  cascade = {};
+  const int order = std::clamp(Config::options.oscilloscope.lowpass.order, 0, static_cast<int>(2 * maxSections));
+  const size_t sections = order / 2;
   float w0 = 2.f * M_PI * Config::options.oscilloscope.lowpass.cutoff / Config::options.audio.sample_rate;
-  for (int k = 0; k < sections; ++k) {
-    float theta = M_PI * (2.f * k + 1.f) / (2.f * Config::options.oscilloscope.lowpass.order);
+  for (size_t k = 0; k < sections; ++k) {
+    float theta = M_PI * (2.f * k + 1.f) / (2.f * order);
     float sin_theta = sinf(theta);
     float alpha = sinf(w0) / (2.f * sin_theta);
     float b0 = (1.f - cosf(w0)) / 2.f;
@@ -267,15 +438,13 @@ void init() {
     float a0 = 1.f + alpha;
     float a1 = -2.f * cosf(w0);
     float a2 = 1.f - alpha;
-    b0 /= a0;
-    b1 /= a0;
-    b2 /= a0;
-    a1 /= a0;
-    a2 /= a0;
-    biquads.push_back({b0, b1, b2, a1, a2});
+    cascade.b0[k] = b0 / a0;
+    cascade.b1[k] = b1 / a0;
+    cascade.b2[k] = b2 / a0;
+    cascade.a1[k] = a1 / a0;
+    cascade.a2[k] = a2 / a0;
   }
-  for (auto& bq : biquads)
-    bq.reset();
+  cascade.sections = sections;
 }
 
 void reconfigure() {
@@ -292,27 +461,171 @@ void reconfigure() {
 }
 
 void process() {
-  for (size_t i = 0; i < bufferSize; i++) {
-    size_t readIdx = (writePos + i) % bufferSize;
-    float filtered = bufferMid[readIdx];
-    for (auto& bq : biquads)
-      filtered = bq.process(filtered);
-    lowpassed[readIdx] = filtered;
+  // Only frames published since the previous call are filtered; the cascade state carries over
+  static RingBuffer::Reader reader;
+  const RingBuffer::Span span = ring.poll(reader, bufferSize);
+  Cascade& c = cascade;
+
+  if (c.sections == 0) {
+    // Stateless, a lapped span only passes through what the ring holds now
+    ring.read(span, [&span](const float* mid, const float*, size_t offset, size_t len) {
+      for (size_t i = 0; i < len; i++)
+        lowpassed[ring.index(span.begin + offset + i)] = mid[i];
+    });
+    return;
+  }
+
+  // Output of the last section describes the frame sections - 1 steps back
+  const size_t last = c.sections - 1;
+
+#ifdef HAVE_AVX2
+  const __m256 b0 = _mm256_load_ps(c.b0);
+  const __m256 b1 = _mm256_load_ps(c.b1);
+  const __m256 b2 = _mm256_load_ps(c.b2);
+  const __m256 a1 = _mm256_load_ps(c.a1);
+  const __m256 a2 = _mm256_load_ps(c.a2);
+  const __m256i shift = _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6);
+  const __m256i pick = _mm256_set1_epi32(static_cast<int>(last));
+  __m256 s1 = _mm256_load_ps(c.s1);
+  __m256 s2 = _mm256_load_ps(c.s2);
+  __m256 y = _mm256_load_ps(c.y);
+  const bool intact = ring.read(span, [&](const float* mid, const float*, size_t offset, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      // Lane k takes lane k - 1's previous output, lane 0 the new sample
+      const __m256 x = _mm256_blend_ps(_mm256_permutevar8x32_ps(y, shift), _mm256_set1_ps(mid[i]), 0x01);
+      y = _mm256_fmadd_ps(b0, x, s1);
+      s1 = _mm256_fnmadd_ps(a1, y, _mm256_fmadd_ps(b1, x, s2));
+      s2 = _mm256_fnmadd_ps(a2, y, _mm256_mul_ps(b2, x));
+      lowpassed[ring.index(span.begin + offset + i - last)] = _mm256_cvtss_f32(_mm256_permutevar8x32_ps(y, pick));
+    }
+  });
+  _mm256_store_ps(c.s1, s1);
+  _mm256_store_ps(c.s2, s2);
+  _mm256_store_ps(c.y, y);
+#else
+  const bool intact = ring.read(span, [&](const float* mid, const float*, size_t offset, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      // Walk the lanes backwards so each one still sees its predecessor's previous output
+      for (size_t k = c.sections; k-- > 0;) {
+        const float x = k == 0 ? mid[i] : c.y[k - 1];
+        const float y = c.b0[k] * x + c.s1[k];
+        c.s1[k] = c.b1[k] * x - c.a1[k] * y + c.s2[k];
+        c.s2[k] = c.b2[k] * x - c.a2[k] * y;
+        c.y[k] = y;
+      }
+      lowpassed[ring.index(span.begin + offset + i - last)] = c.y[last];
+    }
+  });
+#endif
+
+  // The producer lapped us and the cascade ran over overwritten samples, restart it from rest
+  if (!intact) {
+    std::fill_n(c.s1, maxSections, 0.f);
+    std::fill_n(c.s2, maxSections, 0.f);
+    std::fill_n(c.y, maxSections, 0.f);
   }
 }
 }; // namespace Lowpass
 
 namespace ConstantQ {
 
-// Constant Q Transform parameters
-float Q;
-size_t bins;
-std::vector<float> frequencies;
-std::vector<size_t> lengths;
-std::vector<std::vector<float, AlignedAllocator<float, 32>>> reals;
-std::vector<std::vector<float, AlignedAllocator<float, 32>>> imags;
+WorkPool pool;
+
+// Published kernel set; readers pin it with current()
+std::atomic<std::shared_ptr<const Kernels>> published {std::make_shared<const Kernels>()};
+std::atomic<uint64_t> versions {0};
+
+// Settings of the newest requested set, recorded by init() so the first edit after it is seen
+Settings built;
+
+// Background build request, see regenerate()
+std::mutex buildMutex;
+std::condition_variable_any buildCv;
+bool buildPending = false;
+Settings buildSettings;
+std::jthread builderThread;
+
+Settings Settings::fromConfig() {
+  Settings settings;
+  settings.binsPerOctave = Config::options.fft.cqt.bins_per_octave;
+  settings.minFreq = Config::options.fft.limits.min_freq;
+  settings.maxFreq = Config::options.fft.limits.max_freq;
+  settings.fftSize = Config::options.fft.size;
+  settings.sampleRate = Config::options.audio.sample_rate;
+  settings.engine = Config::options.fft.cqt.engine;
+  settings.precision = Config::options.fft.cqt.precision;
+  settings.threads = Config::options.fft.cqt.threads;
+  return settings;
+}
+
+/**
+ * @brief Map an fft.cqt.engine value to its engine, falling back to direct
+ */
+static Engine parseEngine(const std::string& name) {
+  if (name == "sparse")
+    return Engine::Sparse;
+  if (name == "multirate")
+    return Engine::Multirate;
+  if (name == "sliding")
+    return Engine::Sliding;
+  if (name == "symmetric")
+    return Engine::Symmetric;
+  return Engine::Direct;
+}
+
+/**
+ * @brief Resolve fft.cqt.threads to the number of threads sharing the bins
+ */
+static int resolveThreads(int threads) {
+  if (threads <= 0)
+    threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) / 2, 1, 8);
+  return threads;
+}
+
+/**
+ * @brief Convert to IEEE binary16, rounding to nearest even
+ */
+static uint16_t toHalf(float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+  bits &= 0x7fffffffu;
+
+  if (bits > 0x7f800000u)
+    return sign | 0x7e00u;
+  if (bits >= 0x47800000u)
+    return sign | 0x7c00u;
+  // Subnormal range counts in units of 2^-24; rounding up to 1024 yields the smallest normal
+  if (bits < 0x38800000u)
+    return sign | static_cast<uint16_t>(std::nearbyint(std::fabs(value) * 16777216.f));
+
+  uint32_t half = (bits - 0x38000000u) >> 13;
+  const uint32_t rest = bits & 0x1fffu;
+  if (rest > 0x1000u || (rest == 0x1000u && (half & 1)))
+    half++;
+  return sign | static_cast<uint16_t>(half);
+}
+
+/**
+ * @brief Convert from IEEE binary16
+ */
+static float fromHalf(uint16_t half) {
+  const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+  const uint32_t exponent = (half >> 10) & 0x1fu;
+  const uint32_t mantissa = half & 0x3ffu;
+  if (exponent == 0) {
+    const float value = static_cast<float>(mantissa) / 16777216.f;
+    return sign ? -value : value;
+  }
+
+  const uint32_t biased = exponent == 31 ? 0xffu : exponent + 112;
+  const uint32_t bits = sign | (biased << 23) | (mantissa << 13);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
 
-std::pair<size_t, size_t> find(float f) {
+std::pair<size_t, size_t> Kernels::find(float f) const {
   size_t n = frequencies.size();
   if (n == 0)
     return {0, 0};
@@ -334,41 +647,45 @@ std::pair<size_t, size_t> find(float f) {
   return {left - 1, left};
 }
 
-void init() {
+void initBins(Kernels& kernels) {
   // Calculate number of frequency bins
-  float octaves = log2f(Config::options.fft.limits.max_freq / Config::options.fft.limits.min_freq);
-  bins = std::clamp(static_cast<size_t>(ceil(octaves * Config::options.fft.cqt.bins_per_octave)),
-                    static_cast<size_t>(1), static_cast<size_t>(1000));
-  frequencies.resize(bins);
-  lengths.resize(bins);
-  reals.resize(bins);
-  imags.resize(bins);
+  float octaves = log2f(kernels.settings.maxFreq / kernels.settings.minFreq);
+  kernels.bins = std::clamp(static_cast<size_t>(ceil(octaves * kernels.settings.binsPerOctave)),
+                            static_cast<size_t>(1), static_cast<size_t>(1000));
+  kernels.frequencies.resize(kernels.bins);
+  kernels.lengths.resize(kernels.bins);
+  kernels.reals.resize(kernels.bins);
+  kernels.imags.resize(kernels.bins);
 
   // Calculate Q factor and frequency bins
-  float binRatio = 1.f / Config::options.fft.cqt.bins_per_octave;
-  Q = 1.f / (powf(2.f, binRatio) - 1.f);
-  for (int k = 0; k < bins; k++) {
-    frequencies[k] = Config::options.fft.limits.min_freq * powf(2.f, static_cast<float>(k) * binRatio);
+  float binRatio = 1.f / kernels.settings.binsPerOctave;
+  kernels.Q = 1.f / (powf(2.f, binRatio) - 1.f);
+  for (int k = 0; k < kernels.bins; k++) {
+    kernels.frequencies[k] = kernels.settings.minFreq * powf(2.f, static_cast<float>(k) * binRatio);
   }
 }
 
-void genMortletKernel(int bin) {
-  const float& fc = frequencies[bin];
+void genMortletKernel(Kernels& kernels, int bin) {
+  // Multirate bins run at their octave's decimated rate, with the same time span limit
+  const int level = kernels.levels.size() == kernels.bins ? kernels.levels[bin] : 0;
+  const size_t maxLength = std::max<size_t>(kernels.settings.fftSize >> level, 1);
+
+  const float& fc = kernels.frequencies[bin];
   float omega = 2 * M_PI * fc;
-  float sigma = Q / omega;
-  float dt = 1.f / Config::options.audio.sample_rate;
+  float sigma = kernels.Q / omega;
+  float dt = static_cast<float>(1 << level) / kernels.settings.sampleRate;
   size_t length = static_cast<size_t>(ceilf(6.0f * sigma / dt));
-  if (length > Config::options.fft.size) {
-    length = Config::options.fft.size;
+  if (length > maxLength) {
+    length = maxLength;
     sigma = static_cast<float>(length) * dt / 6.0f;
   }
 
   if (length % 2 == 0)
     length++;
 
-  lengths[bin] = length;
-  reals[bin].resize(length);
-  imags[bin].resize(length);
+  kernels.lengths[bin] = length;
+  kernels.reals[bin].resize(length);
+  kernels.imags[bin].resize(length);
 
   // Generate Mortlet wavelet kernel
   ssize_t center = length / 2;
@@ -381,8 +698,8 @@ void genMortletKernel(int bin) {
   for (ssize_t n = 0; n < length; n++) {
     float t = static_cast<float>(n - center) * dt;
     float envelope = expf(-(t * t) / (2 * sigma * sigma));
-    reals[bin][n] = envelope * cosPhase;
-    imags[bin][n] = envelope * sinPhase;
+    kernels.reals[bin][n] = envelope * cosPhase;
+    kernels.imags[bin][n] = envelope * sinPhase;
     norm += envelope;
     float newCos = cosPhase * cosDelta - sinPhase * sinDelta;
     float newSin = sinPhase * cosDelta + cosPhase * sinDelta;
@@ -394,503 +711,2105 @@ void genMortletKernel(int bin) {
   if (norm > 0.f) {
     float ampNorm = 1.f / norm;
     for (size_t n = 0; n < length; n++) {
-      reals[bin][n] *= ampNorm;
-      imags[bin][n] *= ampNorm;
+      kernels.reals[bin][n] *= ampNorm;
+      kernels.imags[bin][n] *= ampNorm;
     }
   }
 }
 
-void generate() {
-  // Generate kernels for all frequency bins
-  for (int k = 0; k < bins; k++) {
-    genMortletKernel(k);
+void genSparseKernels(Kernels& kernels) {
+  const size_t size = kernels.settings.fftSize;
+  const size_t half = size / 2 + 1;
+  kernels.sparse.assign(kernels.bins, {});
+  kernels.sparseSize = 0;
+
+  fftwf_complex* buf = fftwf_alloc_complex(size);
+  fftwf_plan plan = nullptr;
+  if (buf) {
+    std::lock_guard<std::mutex> lock(FFT::plannerMutex);
+    plan = fftwf_plan_dft_1d(size, buf, buf, FFTW_FORWARD, FFTW_ESTIMATE);
+  }
+  if (!plan) {
+    logWarnAt(std::source_location::current(), "Failed to plan sparse CQT kernels");
+    fftwf_free(buf);
+    return;
   }
-}
-
-bool regenerate() {
-  static int lastCQTBins = Config::options.fft.cqt.bins_per_octave;
-  static float lastMinFreq = Config::options.fft.limits.min_freq;
-  static float lastMaxFreq = Config::options.fft.limits.max_freq;
 
-  // Check if regeneration is needed
-  if (lastCQTBins == Config::options.fft.cqt.bins_per_octave && lastMinFreq == Config::options.fft.limits.min_freq &&
-      lastMaxFreq == Config::options.fft.limits.max_freq) [[likely]]
-    return false;
+  // Dense accumulators over the half spectrum, compacted per bin
+  std::vector<float> a(half), b(half), c(half), d(half);
+  std::vector<uint8_t> used(half);
 
-  lastCQTBins = Config::options.fft.cqt.bins_per_octave;
-  lastMinFreq = Config::options.fft.limits.min_freq;
-  lastMaxFreq = Config::options.fft.limits.max_freq;
+  for (size_t k = 0; k < kernels.bins; k++) {
+    // Place the kernel where compute() aligns it: ending at the newest sample of the size-long frame. Kernels of
+    // size + 1 taps lose their oldest one.
+    const size_t length = std::min(kernels.lengths[k], size);
+    const size_t skip = kernels.lengths[k] - length;
+    std::fill_n(reinterpret_cast<float*>(buf), size * 2, 0.f);
+    for (size_t n = 0; n < length; n++) {
+      buf[size - length + n][0] = kernels.reals[k][skip + n];
+      buf[size - length + n][1] = kernels.imags[k][skip + n];
+    }
+    fftwf_execute(plan);
+
+    float peak = 0.f;
+    for (size_t j = 0; j < size; j++)
+      peak = std::max(peak, buf[j][0] * buf[j][0] + buf[j][1] * buf[j][1]);
+    const float threshold = peak * sparseThreshold * sparseThreshold;
+
+    // sum_n x[n] conj(h[n]) = 1/N sum_j X[j] conj(H[j]); the real input's X[N-j] = conj(X[j]) folds
+    // every term onto the half spectrum as Xr * (a + ic) + Xi * (b + id)
+    std::fill(a.begin(), a.end(), 0.f);
+    std::fill(b.begin(), b.end(), 0.f);
+    std::fill(c.begin(), c.end(), 0.f);
+    std::fill(d.begin(), d.end(), 0.f);
+    std::fill(used.begin(), used.end(), 0);
+    for (size_t j = 0; j < size; j++) {
+      if (buf[j][0] * buf[j][0] + buf[j][1] * buf[j][1] < threshold)
+        continue;
+      const float cr = buf[j][0] / size;
+      const float ci = -buf[j][1] / size;
+      const bool mirrored = j > size / 2;
+      const size_t m = mirrored ? size - j : j;
+      const float s = mirrored ? -1.f : 1.f;
+      a[m] += cr;
+      b[m] -= s * ci;
+      c[m] += ci;
+      d[m] += s * cr;
+      used[m] = 1;
+    }
 
-  init();
-  generate();
+    SparseKernel& kernel = kernels.sparse[k];
+    for (size_t m = 0; m < half; m++) {
+      if (!used[m])
+        continue;
+      kernel.index.push_back(static_cast<int32_t>(m));
+      kernel.a.push_back(a[m]);
+      kernel.b.push_back(b[m]);
+      kernel.c.push_back(c[m]);
+      kernel.d.push_back(d[m]);
+    }
+  }
 
-  return true;
+  {
+    std::lock_guard<std::mutex> lock(FFT::plannerMutex);
+    fftwf_destroy_plan(plan);
+  }
+  fftwf_free(buf);
+  kernels.sparseSize = size;
 }
 
-template <typename Alloc>
-void compute(const std::vector<float, Alloc>& inA, const std::vector<float, Alloc>& inB, float gainA, float gainB,
-             std::vector<float>& out, std::vector<float>& phase) {
-  if (inA.empty())
-    return;
-
-  if (inB.size() != inA.size())
-    return;
-
-  const bool useSecond = std::abs(gainB) > FLT_EPSILON;
-
-  out.resize(bins);
-  phase.resize(bins);
+void genHalfband(Kernels& kernels) {
+  // Windowed-sinc half-band lowpass: every even tap but the center is zero, so only odd offsets are stored
+  constexpr int half = halfbandTaps / 2;
+  std::vector<float> win = FIR::kaiser_window(halfbandTaps, halfbandBeta);
+  kernels.halfband.resize((half + 1) / 2);
+  float sum = 0.f;
+  for (size_t k = 0; k < kernels.halfband.size(); k++) {
+    const int n = 2 * static_cast<int>(k) + 1;
+    kernels.halfband[k] = static_cast<float>(std::sin(M_PI * n / 2.0) / (M_PI * n)) * win[half + n];
+    sum += kernels.halfband[k];
+  }
 
-  const size_t ringSize = inA.size();
+  // Unity gain at DC: 0.5 + 2 * sum(odd taps) == 1
+  for (auto& h : kernels.halfband)
+    h *= 0.25f / sum;
+}
 
-#ifdef HAVE_AVX2
-  // SIMD-optimized processing function
-  auto process_segment = [useSecond, gainA, gainB](const float* bufA, const float* bufB, const float* real,
-                                                   const float* imag, size_t length) -> std::pair<float, float> {
-    size_t n = 0;
-    __m256 realSumVec = _mm256_setzero_ps();
-    __m256 imagSumVec = _mm256_setzero_ps();
-    __m256 gainAVec = _mm256_set1_ps(gainA);
-    __m256 gainBVec = _mm256_set1_ps(gainB);
-
-    bool aligned = (((uintptr_t)bufA % 32) == 0) && (((uintptr_t)real % 32) == 0) && (((uintptr_t)imag % 32) == 0) &&
-                   (!useSecond || ((uintptr_t)bufB % 32) == 0);
-
-    if (aligned) {
-      for (; n + 7 < length; n += 8) {
-        __m256 sampleVec = _mm256_mul_ps(_mm256_load_ps(bufA + n), gainAVec);
-        if (useSecond)
-          sampleVec = _mm256_fmadd_ps(_mm256_load_ps(bufB + n), gainBVec, sampleVec);
-        __m256 realVec = _mm256_load_ps(real + n);
-        __m256 imagVec = _mm256_load_ps(imag + n);
-        realSumVec = _mm256_fmadd_ps(sampleVec, realVec, realSumVec);
-        imagSumVec = _mm256_fnmadd_ps(sampleVec, imagVec, imagSumVec);
-      }
-    } else {
-      for (; n + 7 < length; n += 8) {
-        __m256 sampleVec = _mm256_mul_ps(_mm256_loadu_ps(bufA + n), gainAVec);
-        if (useSecond)
-          sampleVec = _mm256_fmadd_ps(_mm256_loadu_ps(bufB + n), gainBVec, sampleVec);
-        __m256 realVec = _mm256_loadu_ps(real + n);
-        __m256 imagVec = _mm256_loadu_ps(imag + n);
-        realSumVec = _mm256_fmadd_ps(sampleVec, realVec, realSumVec);
-        imagSumVec = _mm256_fnmadd_ps(sampleVec, imagVec, imagSumVec);
-      }
-    }
+void genHalfKernels(Kernels& kernels) {
+  kernels.halfReals.clear();
+  kernels.halfImags.clear();
+  kernels.halfScales.clear();
 
-    float realSum = avx2_reduce_add_ps(realSumVec);
-    float imagSum = avx2_reduce_add_ps(imagSumVec);
+  // Only the time-domain engines stream the kernels every frame
+  if (kernels.settings.precision != "half" ||
+      (kernels.engine != Engine::Direct && kernels.engine != Engine::Multirate))
+    return;
 
-    for (; n < length; ++n) {
-      float sample = bufA[n] * gainA + (useSecond ? bufB[n] * gainB : 0.0f);
-      realSum += sample * real[n];
-      imagSum -= sample * imag[n];
+  kernels.halfReals.resize(kernels.bins);
+  kernels.halfImags.resize(kernels.bins);
+  kernels.halfScales.resize(kernels.bins);
+  size_t samples = 0;
+  for (size_t k = 0; k < kernels.bins; k++) {
+    // Kernels are normalized to a tiny sum, scale each to a unit peak so its tails stay out of the subnormals
+    float peak = 0.f;
+    for (size_t n = 0; n < kernels.lengths[k]; n++)
+      peak = std::max({peak, std::abs(kernels.reals[k][n]), std::abs(kernels.imags[k][n])});
+    const float scale = peak > 0.f ? peak : 1.f;
+    kernels.halfScales[k] = scale;
+
+    kernels.halfReals[k].resize(kernels.lengths[k]);
+    kernels.halfImags[k].resize(kernels.lengths[k]);
+    for (size_t n = 0; n < kernels.lengths[k]; n++) {
+      kernels.halfReals[k][n] = toHalf(kernels.reals[k][n] / scale);
+      kernels.halfImags[k][n] = toHalf(kernels.imags[k][n] / scale);
     }
+    samples += kernels.lengths[k];
+  }
 
-    return {realSum, imagSum};
-  };
-#endif
+  logDebug("CQT kernels in half precision: {} KiB instead of {} KiB", samples * 2 * sizeof(uint16_t) / 1024,
+           samples * 2 * sizeof(float) / 1024);
+}
 
-  // Process each frequency bin
-  for (int k = 0; k < bins; k++) {
-    const auto& kReals = reals[k];
-    const auto& kImags = imags[k];
-    size_t length = lengths[k];
-    size_t start = (writePos + ringSize - length) % ringSize;
+void genFoldedKernels(Kernels& kernels) {
+  kernels.foldReals.resize(kernels.bins);
+  kernels.foldImags.resize(kernels.bins);
+  for (size_t k = 0; k < kernels.bins; k++) {
+    // Odd length, so center c pairs every n > 0 with c - n; the imaginary center tap is sin(0) = 0
+    const size_t center = kernels.lengths[k] / 2;
+    kernels.foldReals[k].assign(kernels.reals[k].begin() + center, kernels.reals[k].end());
+    kernels.foldImags[k].assign(kernels.imags[k].begin() + center, kernels.imags[k].end());
+    kernels.foldImags[k][0] = 0.f;
+  }
+}
 
-    float realSum = 0.f;
-    float imagSum = 0.f;
+void genSlidingBins(Kernels& kernels) {
+  kernels.slidingBins.assign(kernels.bins, {});
+  for (size_t k = 0; k < kernels.bins; k++) {
+    SlidingBin& bin = kernels.slidingBins[k];
+    bin.length = std::max<size_t>(kernels.lengths[k], 3);
+    const double n = static_cast<double>(bin.length - 1);
+    const double omega = 2.0 * M_PI * kernels.frequencies[k] / kernels.settings.sampleRate;
+    const double delta = 2.0 * M_PI / n;
+    const double omegas[3] = {omega, omega - delta, omega + delta};
+    for (int m = 0; m < 3; m++) {
+      bin.rotRe[m] = std::cos(omegas[m]);
+      bin.rotIm[m] = std::sin(omegas[m]);
+      bin.tailRe[m] = std::cos(omegas[m] * n);
+      bin.tailIm[m] = -std::sin(omegas[m] * n);
+    }
 
-#ifdef HAVE_AVX2
-    // Handle buffer wrapping with SIMD optimization
-    if (start + length <= ringSize) {
-      auto result = process_segment(&inA[start], &inB[start], kReals.data(), kImags.data(), length);
-      realSum = result.first;
-      imagSum = result.second;
-    } else {
-      size_t firstLen = ringSize - start;
-      size_t secondLen = length - firstLen;
+    // The Hann window of length n + 1 sums to n / 2, and compute() scales by 2 / sum
+    bin.centerRe = std::cos(omega * n / 2.0) * 4.0 / n;
+    bin.centerIm = std::sin(omega * n / 2.0) * 4.0 / n;
+  }
+}
 
-      auto result1 = process_segment(&inA[start], &inB[start], kReals.data(), kImags.data(), firstLen);
-      realSum += result1.first;
-      imagSum += result1.second;
+void assignLevels(Kernels& kernels) {
+  kernels.levels.assign(kernels.bins, 0);
+  kernels.levelCount = 1;
+  if (kernels.engine != Engine::Multirate)
+    return;
 
-      auto result2 = process_segment(&inA[0], &inB[0], kReals.data() + firstLen, kImags.data() + firstLen, secondLen);
-      realSum += result2.first;
-      imagSum += result2.second;
-    }
-#else
-    // Standard processing without SIMD
-    for (size_t n = 0; n < length; n++) {
-      size_t bufferIdx = (start + n) % ringSize;
-      float sample = inA[bufferIdx] * gainA + (useSecond ? inB[bufferIdx] * gainB : 0.0f);
-      realSum += sample * kReals[n];
-      imagSum -= sample * kImags[n];
-    }
-#endif
-    out[k] = std::sqrt(realSum * realSum + imagSum * imagSum) * 2.f;
-    phase[k] = std::atan2(imagSum, realSum);
+  // Deepest level whose clean band still holds the bin and whose kernels keep a useful length
+  int maxLevel = 0;
+  while (maxLevel < 16 && (kernels.settings.fftSize >> (maxLevel + 1)) >= minLevelLength)
+    maxLevel++;
+
+  for (size_t k = 0; k < kernels.bins; k++) {
+    int level = 0;
+    while (level < maxLevel &&
+           kernels.frequencies[k] < multiratePassband * kernels.settings.sampleRate / static_cast<float>(2 << level))
+      level++;
+    kernels.levels[k] = level;
+    kernels.levelCount = std::max(kernels.levelCount, level + 1);
   }
 }
-} // namespace ConstantQ
-
-namespace FFT {
 
-// FFTW plans and buffers
-std::mutex mutexMid;
-std::mutex mutexSide;
-fftwf_plan mid;
-fftwf_plan side;
-float* inMid;
-float* inSide;
-fftwf_complex* outMid;
-fftwf_complex* outSide;
+void configurePool(int threads) { pool.resize(static_cast<size_t>(resolveThreads(threads) - 1)); }
 
-void init() {
-  int& size = Config::options.fft.size;
-  inMid = fftwf_alloc_real(size);
-  inSide = fftwf_alloc_real(size);
-  outMid = fftwf_alloc_complex(size / 2 + 1);
-  outSide = fftwf_alloc_complex(size / 2 + 1);
-  mid = fftwf_plan_dft_r2c_1d(size, inMid, outMid, FFTW_ESTIMATE);
-  side = fftwf_plan_dft_r2c_1d(size, inSide, outSide, FFTW_ESTIMATE);
+void partition(Kernels& kernels) {
+  kernels.partitions.assign(1, 0);
+  if (kernels.bins == 0)
+    return;
 
-  if (!inMid || !inSide || !outMid || !outSide || !mid || !side)
-    logWarnAt(std::source_location::current(), "Failed to allocate FFTW buffers");
-}
+  // Balance by work per bin: kernel length for time-domain engines, nonzero entries for the sparse one,
+  // and the same new frames for every bin of the sliding one
+  auto cost = [&kernels](size_t k) -> double {
+    if (kernels.engine == Engine::Sliding)
+      return 1.0;
+    if (kernels.engine == Engine::Sparse && kernels.sparse.size() == kernels.bins)
+      return static_cast<double>(kernels.sparse[k].index.size()) + 1.0;
+    return static_cast<double>(kernels.lengths[k]);
+  };
+  double total = 0.0;
+  for (size_t k = 0; k < kernels.bins; k++)
+    total += cost(k);
 
-void cleanup() {
-  if (mid) {
-    fftwf_destroy_plan(mid);
-    mid = nullptr;
-  }
-  if (side) {
-    fftwf_destroy_plan(side);
-    side = nullptr;
+  // A few chunks per thread leaves room for stealing
+  const size_t chunks = std::min<size_t>(kernels.bins, resolveThreads(kernels.settings.threads) * 4);
+  double acc = 0.0;
+  for (size_t k = 0; k < kernels.bins; k++) {
+    acc += cost(k);
+    if (acc >= total * kernels.partitions.size() / chunks && kernels.partitions.size() < chunks)
+      kernels.partitions.push_back(k + 1);
   }
+  if (kernels.partitions.back() != kernels.bins)
+    kernels.partitions.push_back(kernels.bins);
+}
 
-  if (inMid) {
-    fftwf_free(inMid);
-    inMid = nullptr;
-  }
-  if (inSide) {
-    fftwf_free(inSide);
-    inSide = nullptr;
+void forEachBin(const Kernels& kernels, const std::function<void(size_t)>& fn) {
+  const std::vector<size_t>& partitions = kernels.partitions;
+  if (pool.size() == 0 || partitions.size() < 3 || partitions.back() != kernels.bins) {
+    for (size_t k = 0; k < kernels.bins; k++)
+      fn(k);
+    return;
   }
 
-  if (outMid) {
-    fftwf_free(outMid);
-    outMid = nullptr;
-  }
-  if (outSide) {
-    fftwf_free(outSide);
-    outSide = nullptr;
-  }
+  pool.run(partitions.size() - 1, [&fn, &partitions](size_t p) {
+    for (size_t k = partitions[p]; k < partitions[p + 1]; k++)
+      fn(k);
+  });
 }
 
-bool recreatePlans() {
-  static size_t lastFFTSize = Config::options.fft.size;
-  static bool lastCQTState = Config::options.fft.cqt.enabled;
-  static float lastSampleRate = Config::options.audio.sample_rate;
-
-  // Check if FFT plans need to be recreated
-  if (lastFFTSize == Config::options.fft.size && lastCQTState == Config::options.fft.cqt.enabled &&
-      lastSampleRate == Config::options.audio.sample_rate) [[likely]]
-    return false;
-
-  lastFFTSize = Config::options.fft.size;
-  lastCQTState = Config::options.fft.cqt.enabled;
-  lastSampleRate = Config::options.audio.sample_rate;
-
-  std::lock_guard<std::mutex> lockMid(mutexMid);
-  std::lock_guard<std::mutex> lockSide(mutexSide);
+void generate(Kernels& kernels) {
+  assignLevels(kernels);
+  if (kernels.engine == Engine::Multirate)
+    genHalfband(kernels);
 
-  cleanup();
-  init();
+  // Generate kernels for all frequency bins
+  for (int k = 0; k < kernels.bins; k++) {
+    genMortletKernel(kernels, k);
+  }
 
-  if (!inMid || !inSide || !outMid || !outSide || !mid || !side)
-    logWarnAt(std::source_location::current(), "Failed to allocate FFTW buffers");
+  if (kernels.engine == Engine::Sparse)
+    genSparseKernels(kernels);
+  if (kernels.engine == Engine::Sliding)
+    genSlidingBins(kernels);
+  if (kernels.engine == Engine::Symmetric)
+    genFoldedKernels(kernels);
+  genHalfKernels(kernels);
 
-  return true;
+  partition(kernels);
 }
-} // namespace FFT
 
-namespace Threads {
-
-// Thread synchronization
-std::binary_semaphore fftMainSem {0};
-std::binary_semaphore fftAltSem {0};
+std::shared_ptr<const Kernels> current() { return published.load(std::memory_order_acquire); }
 
-int FFTMain(std::stop_token stoken) {
-  std::stop_callback cb {stoken, [] { fftMainSem.release(); }};
+std::shared_ptr<Kernels> build(const Settings& settings) {
+  auto kernels = std::make_shared<Kernels>();
+  kernels->settings = settings;
+  kernels->engine = parseEngine(settings.engine);
+  kernels->version = versions.fetch_add(1, std::memory_order_relaxed) + 1;
+  initBins(*kernels);
+  generate(*kernels);
+  return kernels;
+}
 
+void builderMain(std::stop_token stoken) {
   while (true) {
-    fftMainSem.acquire();
-    if (stoken.stop_requested())
-      break;
+    Settings settings;
+    {
+      std::unique_lock<std::mutex> lock(buildMutex);
+      if (!buildCv.wait(lock, stoken, [] { return buildPending; }))
+        return;
+      buildPending = false;
+      settings = buildSettings;
+    }
 
-    // Process main channel FFT
-    if (Config::options.fft.cqt.enabled) {
-      if (Config::options.fft.mode == "leftright") {
-        ConstantQ::compute(bufferMid, bufferSide, -0.5f, 0.5f, fftMidRaw, fftMidPhase);
-      } else {
-        ConstantQ::compute(bufferMid, bufferSide, 1.0f, 0.0f, fftMidRaw, fftMidPhase);
-      }
-    } else {
-      fftMidRaw.resize(Config::options.fft.size / 2 + 1);
-      fftMidPhase.resize(Config::options.fft.size / 2 + 1);
-      size_t start = (writePos + bufferSize - Config::options.fft.size) % bufferSize;
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const Kernels> kernels = build(settings);
 
-      // Apply window function and prepare FFT input
-      for (int i = 0; i < Config::options.fft.size; i++) {
-        float win = 0.5f * (1.f - cos(2.f * M_PI * i / (Config::options.fft.size)));
-        size_t pos = (start + i) % bufferSize;
-        if (Config::options.fft.mode == "leftright")
-          FFT::inMid[i] = (bufferSide[pos] - bufferMid[pos]) * 0.5f * win;
-        else
-          FFT::inMid[i] = bufferMid[pos] * win;
-      }
+    // A newer request supersedes this set, skip straight to it
+    {
+      std::lock_guard<std::mutex> lock(buildMutex);
+      if (buildPending)
+        continue;
+    }
 
-      // Execute FFT
-      {
-        std::lock_guard<std::mutex> lockFft(FFT::mutexMid);
-        fftwf_execute(FFT::mid);
-      }
+    // Readers still holding the old set keep it alive; the last one to let go frees it
+    published.store(std::move(kernels), std::memory_order_release);
+    logDebug("Built {} CQT kernels in {:.0f} ms", current()->bins,
+             std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
+}
 
-      // Convert to magnitude spectrum
-      const float scale = 2.f / Config::options.fft.size;
-      for (int i = 0; i < Config::options.fft.size / 2 + 1; i++) {
-        float mag = sqrt(FFT::outMid[i][0] * FFT::outMid[i][0] + FFT::outMid[i][1] * FFT::outMid[i][1]) * scale;
-        if (i != 0 && i != Config::options.fft.size / 2)
-          mag *= 2.f;
-        fftMidRaw[i] = mag;
-      }
+void init() {
+  const Settings settings = Settings::fromConfig();
+  configurePool(settings.threads);
+  published.store(build(settings), std::memory_order_release);
+  built = settings;
 
-      // Convert to phase spectrum
-      for (int i = 0; i < Config::options.fft.size / 2 + 1; i++) {
-        fftMidPhase[i] = std::atan2(FFT::outMid[i][1], FFT::outMid[i][0]);
-      }
-    }
+  if (!builderThread.joinable())
+    builderThread = std::jthread(builderMain);
+}
 
-    // Find peak frequency for pitch detection
-    float peakDb = -INFINITY;
-    float peakFreq = 0.f;
-    uint32_t peakBin = 0;
+void cleanup() {
+  if (builderThread.joinable()) {
+    builderThread.request_stop();
+    builderThread.join();
+  }
+}
 
-    for (int i = 0; i < fftMidRaw.size(); i++) {
-      float mag = fftMidRaw[i];
-      float dB = 20.f * log10f(mag + FLT_EPSILON);
-      if (dB > peakDb) {
-        peakBin = i;
-        peakDb = dB;
-      }
-    };
+bool regenerate() {
+  const Settings settings = Settings::fromConfig();
+  if (settings == built) [[likely]]
+    return false;
 
-    // Interpolate peak frequency
-    float y1 = fftMidRaw[std::max(0, static_cast<int>(peakBin) - 1)];
-    float y2 = fftMidRaw[peakBin];
-    float y3 = fftMidRaw[std::min(static_cast<uint32_t>(fftMidRaw.size() - 1), peakBin + 1)];
-    float denom = y1 - 2.f * y2 + y3;
-    if (Config::options.fft.cqt.enabled) {
-      if (std::abs(denom) > FLT_EPSILON) {
-        float offset = std::clamp(0.5f * (y1 - y3) / denom, -0.5f, 0.5f);
-        float binInterp = static_cast<float>(peakBin) + offset;
-        float logMinFreq = log2f(Config::options.fft.limits.min_freq);
-        float binRatio = 1.f / Config::options.fft.cqt.bins_per_octave;
-        float intpLog = logMinFreq + binInterp * binRatio;
-        peakFreq = powf(2.f, intpLog);
-      } else
-        peakFreq = ConstantQ::frequencies[peakBin];
-    } else {
-      if (std::abs(denom) > FLT_EPSILON) {
-        float offset = std::clamp(0.5f * (y1 + y3) / denom, -0.5f, 0.5f);
-        peakFreq = (peakBin + offset) * Config::options.audio.sample_rate / Config::options.fft.size;
-      } else
-        peakFreq = static_cast<float>(peakBin * Config::options.audio.sample_rate) / Config::options.fft.size;
-    }
+  // The pool is safe to resize while jobs run, the partitions follow with the new set
+  if (settings.threads != built.threads)
+    configurePool(settings.threads);
+  built = settings;
 
-    pitch = peakFreq;
-    pitchDB = peakDb;
+  {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    buildPending = true;
+    buildSettings = settings;
+  }
+  buildCv.notify_one();
+  return true;
+}
 
-    // Apply smoothing if enabled
-    if (Config::options.fft.smoothing.enabled) {
-      fftMid.resize(fftMidRaw.size());
-      size_t bins = fftMid.size();
-      size_t i = 0;
-      bool hovering =
-          !Config::options.fft.sphere.enabled && !Config::options.phosphor.enabled && Config::options.fft.cursor;
-      auto window = VisualizerRegistry::find("spectrum_analyzer").lock();
-      hovering = hovering && window->hovering;
-      const float riseSpeed = Config::options.fft.smoothing.rise_speed * WindowManager::dt;
-      const float fallSpeed =
-          (hovering ? Config::options.fft.smoothing.hover_fall_speed : Config::options.fft.smoothing.fall_speed) *
-          WindowManager::dt;
-
-      // SIMD-optimized smoothing
 #ifdef HAVE_AVX2
-      const __m256 riseSpeedVec = _mm256_set1_ps(riseSpeed);
-      const __m256 fallSpeedVec = _mm256_set1_ps(fallSpeed);
-      const __m256 minVVec = _mm256_set1_ps(FLT_EPSILON);
-      const __m256 dbScaleVec = _mm256_set1_ps(20.0f);
-      const __m256 oneVec = _mm256_set1_ps(1.0f);
-      const __m256 negOneVec = _mm256_set1_ps(-1.0f);
-      for (; i + 7 < bins; i += 8) {
-        __m256 cur = _mm256_loadu_ps(&fftMidRaw[i]);
-        __m256 prev = _mm256_loadu_ps(&fftMid[i]);
+template <bool Aligned> static inline __m256 loadKernel(const float* p) {
+  return Aligned ? _mm256_load_ps(p) : _mm256_loadu_ps(p);
+}
 
-        __m256 curDB = _mm256_mul_ps(_mm256_log10_ps(_mm256_add_ps(cur, minVVec)), dbScaleVec);
-        __m256 prevDB = _mm256_mul_ps(_mm256_log10_ps(_mm256_add_ps(prev, minVVec)), dbScaleVec);
+template <bool Aligned> static inline __m256 loadKernel(const uint16_t* p) {
+  const __m128i* q = reinterpret_cast<const __m128i*>(p);
+  return _mm256_cvtph_ps(Aligned ? _mm_load_si128(q) : _mm_loadu_si128(q));
+}
+#endif
 
-        __m256 diff = _mm256_sub_ps(curDB, prevDB);
-        __m256 isRise = _mm256_cmp_ps(diff, _mm256_setzero_ps(), _CMP_GT_OS);
+static inline float kernelValue(float v) { return v; }
+static inline float kernelValue(uint16_t v) { return fromHalf(v); }
 
-        __m256 absDiff = _mm256_andnot_ps(_mm256_set1_ps(-0.f), diff);
-        __m256 change = _mm256_mul_ps(_mm256_min_ps(absDiff, _mm256_blendv_ps(fallSpeedVec, riseSpeedVec, isRise)),
-                                      _mm256_blendv_ps(negOneVec, oneVec, isRise));
+/**
+ * @brief Correlate one kernel with a contiguous segment of (optionally mixed) input
+ * @return Real and imaginary parts of sum(x * conj(kernel))
+ */
+template <typename K>
+static std::pair<float, float> kernelDot(const float* bufA, const float* bufB, float gainA, float gainB, const K* real,
+                                         const K* imag, size_t length) {
+  const bool useSecond = bufB && std::abs(gainB) > FLT_EPSILON;
+  size_t n = 0;
+  float realSum = 0.f;
+  float imagSum = 0.f;
 
-        __m256 newDB =
-            _mm256_blendv_ps(_mm256_add_ps(prevDB, change), curDB,
-                             _mm256_cmp_ps(absDiff, _mm256_blendv_ps(fallSpeedVec, riseSpeedVec, isRise), _CMP_LE_OS));
+#ifdef HAVE_AVX2
+  __m256 realSumVec = _mm256_setzero_ps();
+  __m256 imagSumVec = _mm256_setzero_ps();
+  __m256 gainAVec = _mm256_set1_ps(gainA);
+  __m256 gainBVec = _mm256_set1_ps(gainB);
+
+  bool aligned = (((uintptr_t)bufA % 32) == 0) && (((uintptr_t)real % 32) == 0) && (((uintptr_t)imag % 32) == 0) &&
+                 (!useSecond || ((uintptr_t)bufB % 32) == 0);
+
+  if (aligned) {
+    for (; n + 7 < length; n += 8) {
+      __m256 sampleVec = _mm256_mul_ps(_mm256_load_ps(bufA + n), gainAVec);
+      if (useSecond)
+        sampleVec = _mm256_fmadd_ps(_mm256_load_ps(bufB + n), gainBVec, sampleVec);
+      __m256 realVec = loadKernel<true>(real + n);
+      __m256 imagVec = loadKernel<true>(imag + n);
+      realSumVec = _mm256_fmadd_ps(sampleVec, realVec, realSumVec);
+      imagSumVec = _mm256_fnmadd_ps(sampleVec, imagVec, imagSumVec);
+    }
+  } else {
+    for (; n + 7 < length; n += 8) {
+      __m256 sampleVec = _mm256_mul_ps(_mm256_loadu_ps(bufA + n), gainAVec);
+      if (useSecond)
+        sampleVec = _mm256_fmadd_ps(_mm256_loadu_ps(bufB + n), gainBVec, sampleVec);
+      __m256 realVec = loadKernel<false>(real + n);
+      __m256 imagVec = loadKernel<false>(imag + n);
+      realSumVec = _mm256_fmadd_ps(sampleVec, realVec, realSumVec);
+      imagSumVec = _mm256_fnmadd_ps(sampleVec, imagVec, imagSumVec);
+    }
+  }
 
-        __m256 newVal = _mm256_sub_ps(_mm256_pow_ps(_mm256_set1_ps(10.f), _mm256_div_ps(newDB, dbScaleVec)), minVVec);
-        _mm256_storeu_ps(&fftMid[i], newVal);
-      }
+  realSum = avx2_reduce_add_ps(realSumVec);
+  imagSum = avx2_reduce_add_ps(imagSumVec);
 #endif
-      // Standard smoothing
-      for (; i < bins; ++i) {
-        float currentDB = 20.f * log10f(fftMidRaw[i] + FLT_EPSILON);
-        float prevDB = 20.f * log10f(fftMid[i] + FLT_EPSILON);
-        float diff = currentDB - prevDB;
-        float speed = diff > 0 ? riseSpeed : fallSpeed;
-        float absDiff = std::abs(diff);
-        float change = std::min(absDiff, speed) * (diff > 0.f ? 1.f : -1.f);
-        float newDB;
-        if (absDiff <= speed)
-          newDB = currentDB;
-        else
-          newDB = prevDB + change;
-        fftMid[i] = powf(10.f, newDB / 20.f) - FLT_EPSILON;
-      }
-    }
+
+  for (; n < length; ++n) {
+    float sample = bufA[n] * gainA + (useSecond ? bufB[n] * gainB : 0.0f);
+    realSum += sample * kernelValue(real[n]);
+    imagSum -= sample * kernelValue(imag[n]);
   }
 
-  return 0;
+  return {realSum, imagSum};
 }
 
-int FFTAlt(std::stop_token stoken) {
-  std::stop_callback cb {stoken, [] { fftAltSem.release(); }};
+/**
+ * @brief Correlate a kernel with the length samples ending at endPos of a ring, handling the wrap
+ */
+template <typename K>
+static std::pair<float, float> ringDot(const float* bufA, const float* bufB, size_t ringSize, size_t endPos,
+                                       float gainA, float gainB, const K* kReals, const K* kImags, size_t length) {
+  length = std::min(length, ringSize);
+  const size_t start = (endPos + ringSize - length) % ringSize;
+
+  if (start + length <= ringSize)
+    return kernelDot(bufA + start, bufB ? bufB + start : nullptr, gainA, gainB, kReals, kImags, length);
+
+  const size_t firstLen = ringSize - start;
+  auto first = kernelDot(bufA + start, bufB ? bufB + start : nullptr, gainA, gainB, kReals, kImags, firstLen);
+  auto second = kernelDot(bufA, bufB, gainA, gainB, kReals + firstLen, kImags + firstLen, length - firstLen);
+  return {first.first + second.first, first.second + second.second};
+}
 
-  while (true) {
-    fftAltSem.acquire();
+/**
+ * @brief Correlate kernel k with a ring, from the half-precision copy when one is in use
+ */
+static std::pair<float, float> ringDot(const Kernels& kernels, const float* bufA, const float* bufB, size_t ringSize,
+                                       size_t endPos, float gainA, float gainB, size_t k) {
+  if (kernels.halfReals.size() == kernels.bins) {
+    auto [realSum, imagSum] = ringDot(bufA, bufB, ringSize, endPos, gainA, gainB, kernels.halfReals[k].data(),
+                                      kernels.halfImags[k].data(), kernels.lengths[k]);
+    return {realSum * kernels.halfScales[k], imagSum * kernels.halfScales[k]};
+  }
+  return ringDot(bufA, bufB, ringSize, endPos, gainA, gainB, kernels.reals[k].data(), kernels.imags[k].data(),
+                 kernels.lengths[k]);
+}
+
+template <typename Alloc>
+void compute(const Kernels& kernels, const std::vector<float, Alloc>& inA, const std::vector<float, Alloc>& inB,
+             uint64_t end, float gainA, float gainB, std::vector<float>& out, std::vector<float>& phase) {
+  if (inA.empty())
+    return;
+
+  if (inB.size() != inA.size())
+    return;
+
+  out.resize(kernels.bins);
+  phase.resize(kernels.bins);
+
+  const size_t ringSize = inA.size();
+  const size_t endPos = end % ringSize;
+
+  // Process each frequency bin
+  forEachBin(kernels, [&](size_t k) {
+    auto [realSum, imagSum] = ringDot(kernels, inA.data(), inB.data(), ringSize, endPos, gainA, gainB, k);
+    out[k] = std::sqrt(realSum * realSum + imagSum * imagSum) * 2.f;
+    phase[k] = std::atan2(imagSum, realSum);
+  });
+}
+
+void Multirate::reset(const Kernels& kernels, uint64_t end, float mid, float side) {
+  gainMid = mid;
+  gainSide = side;
+  version = kernels.version;
+  cursor = end;
+
+  // Each level keeps its longest kernel plus the half-band history, as a power-of-two ring
+  stages.assign(kernels.levelCount, {});
+  for (int l = 0; l < kernels.levelCount; l++) {
+    size_t need = (static_cast<size_t>(kernels.settings.fftSize) >> l) + halfbandTaps + 1;
+    size_t cap = 1;
+    while (cap < need)
+      cap <<= 1;
+    stages[l].data.assign(cap, 0.f);
+  }
+}
+
+void Multirate::push(const Kernels& kernels, int level, float x) {
+  Stage& stage = stages[level];
+  const size_t mask = stage.data.size() - 1;
+  const uint64_t t = stage.written++;
+  stage.data[t & mask] = x;
+
+  // Every second sample completes one output of the next level, centered halfbandTaps / 2 samples back
+  if (level + 1 >= kernels.levelCount || !(t & 1))
+    return;
+  const uint64_t c = t - halfbandTaps / 2;
+  float y = 0.5f * stage.data[c & mask];
+  for (size_t k = 0; k < kernels.halfband.size(); k++) {
+    const uint64_t o = 2 * k + 1;
+    y += kernels.halfband[k] * (stage.data[(c - o) & mask] + stage.data[(c + o) & mask]);
+  }
+  push(kernels, level + 1, y);
+}
+
+bool Multirate::update(const Kernels& kernels, uint64_t end, float mid, float side) {
+  const size_t history = stages.empty() ? 0 : stages[0].data.size();
+  if (version != kernels.version || mid != gainMid || side != gainSide ||
+      stages.size() != static_cast<size_t>(kernels.levelCount) || end < cursor || end - cursor > history)
+    reset(kernels, end - std::min<uint64_t>(end, kernels.settings.fftSize), mid, side);
+
+  // Feed every frame since the last update through the decimation chain
+  const RingBuffer::Span span {cursor, static_cast<size_t>(end - cursor)};
+  const bool intact = ring.read(span, [this, &kernels](const float* m, const float* s, size_t, size_t len) {
+    for (size_t i = 0; i < len; i++)
+      push(kernels, 0, m[i] * gainMid + s[i] * gainSide);
+  });
+  cursor = end;
+
+  // Torn input would leave garbage in the filter history, start over next time
+  if (!intact)
+    version = 0;
+  return intact;
+}
+
+void computeMultirate(const Kernels& kernels, Multirate& state, uint64_t end, float gainMid, float gainSide,
+                      std::vector<float>& out, std::vector<float>& phase) {
+  if (kernels.levels.size() != kernels.bins || !state.update(kernels, end, gainMid, gainSide))
+    return;
+
+  out.resize(kernels.bins);
+  phase.resize(kernels.bins);
+  forEachBin(kernels, [&](size_t k) {
+    const Multirate::Stage& stage = state.stages[kernels.levels[k]];
+    const size_t ringSize = stage.data.size();
+    auto [realSum, imagSum] =
+        ringDot(kernels, stage.data.data(), nullptr, ringSize, stage.written & (ringSize - 1), 1.f, 0.f, k);
+    out[k] = std::sqrt(realSum * realSum + imagSum * imagSum) * 2.f;
+    phase[k] = std::atan2(imagSum, realSum);
+  });
+}
+
+void computeSliding(const Kernels& kernels, Sliding& state, uint64_t end, float gainMid, float gainSide,
+                    std::vector<float>& out, std::vector<float>& phase) {
+  const size_t size = kernels.settings.fftSize;
+  if (kernels.slidingBins.size() != kernels.bins || end < size)
+    return;
+
+  // Start over from direct sums when the kernels, the mix or the continuity of the input changed
+  const bool seedAll = state.version != kernels.version || state.gainMid != gainMid || state.gainSide != gainSide ||
+                       state.sums.size() != kernels.bins || end < state.cursor || end - state.cursor > size;
+  const size_t step = seedAll ? size : static_cast<size_t>(end - state.cursor);
+
+  // Mix the new frames plus the longest window (kernels are odd, up to size + 1 taps) for the samples leaving each bin
+  const size_t history = size + 1;
+  if (end < step + history)
+    return;
+  const RingBuffer::Span span = ring.latest(end, step + history);
+  if (span.count != step + history)
+    return;
+  state.input.resize(span.count);
+  mixSpan<false>(span, gainMid, gainSide, nullptr, state.input.data());
+  if (!ring.valid(span.begin)) {
+    state.version = 0;
+    return;
+  }
+
+  if (seedAll) {
+    state.sums.assign(kernels.bins, {});
+    state.gainMid = gainMid;
+    state.gainSide = gainSide;
+    state.version = kernels.version;
+  }
+  state.cursor = end;
+
+  out.resize(kernels.bins);
+  phase.resize(kernels.bins);
+
+  // x[i] is frame end - step + i, valid from -history
+  const float* x = state.input.data() + history;
+  forEachBin(kernels, [&, x, step](size_t k) {
+    const SlidingBin& bin = kernels.slidingBins[k];
+    Sliding::Sums& sums = state.sums[k];
+    const ptrdiff_t length = static_cast<ptrdiff_t>(bin.length);
+
+    if (seedAll || step >= bin.length || sums.age + step > slidingResync) {
+      // Direct sum over the newest length frames, cheaper than sliding through a whole window
+      const float* w = x + static_cast<ptrdiff_t>(step) - length;
+      for (int m = 0; m < 3; m++) {
+        double re = 0.0, im = 0.0;
+        double pRe = 1.0, pIm = 0.0;
+        for (ptrdiff_t j = 0; j < length; j++) {
+          re += w[j] * pRe;
+          im += w[j] * pIm;
+          const double next = pRe * bin.rotRe[m] + pIm * bin.rotIm[m];
+          pIm = pIm * bin.rotRe[m] - pRe * bin.rotIm[m];
+          pRe = next;
+        }
+        sums.re[m] = re;
+        sums.im[m] = im;
+      }
+      sums.age = 0;
+    } else {
+      // X <- (X - oldest) * e^(iw) + newest * e^(-iw(length - 1))
+      for (size_t i = 0; i < step; i++) {
+        const double in = x[i];
+        const double outgoing = x[static_cast<ptrdiff_t>(i) - length];
+        for (int m = 0; m < 3; m++) {
+          const double re = sums.re[m] - outgoing;
+          const double im = sums.im[m];
+          sums.re[m] = re * bin.rotRe[m] - im * bin.rotIm[m] + in * bin.tailRe[m];
+          sums.im[m] = re * bin.rotIm[m] + im * bin.rotRe[m] + in * bin.tailIm[m];
+        }
+      }
+      sums.age += step;
+    }
+
+    // Hann window by combining the neighbours, then center the phase like the time-domain kernels
+    const double re = 0.5 * sums.re[0] - 0.25 * (sums.re[1] + sums.re[2]);
+    const double im = 0.5 * sums.im[0] - 0.25 * (sums.im[1] + sums.im[2]);
+    const double realSum = re * bin.centerRe - im * bin.centerIm;
+    const double imagSum = re * bin.centerIm + im * bin.centerRe;
+    out[k] = static_cast<float>(std::sqrt(realSum * realSum + imagSum * imagSum));
+    phase[k] = static_cast<float>(std::atan2(imagSum, realSum));
+  });
+}
+
+/**
+ * @brief Correlate a folded kernel with the samples around center
+ * @return Real and imaginary parts of sum(x * conj(kernel)) over the full kernel
+ */
+static std::pair<float, float> foldDot(const float* center, const float* real, const float* imag, size_t half) {
+  float realSum = center[0] * real[0];
+  float imagSum = 0.f;
+  size_t n = 1;
+
+#ifdef HAVE_AVX2
+  const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  __m256 realVec = _mm256_setzero_ps();
+  __m256 imagVec = _mm256_setzero_ps();
+  for (; n + 7 <= half; n += 8) {
+    __m256 after = _mm256_loadu_ps(center + n);
+    __m256 before = _mm256_permutevar8x32_ps(_mm256_loadu_ps(center - n - 7), reverse);
+    realVec = _mm256_fmadd_ps(_mm256_add_ps(after, before), _mm256_loadu_ps(real + n), realVec);
+    imagVec = _mm256_fmadd_ps(_mm256_sub_ps(after, before), _mm256_loadu_ps(imag + n), imagVec);
+  }
+  realSum += avx2_reduce_add_ps(realVec);
+  imagSum += avx2_reduce_add_ps(imagVec);
+#endif
+
+  for (; n <= half; n++) {
+    realSum += (center[n] + center[-static_cast<ptrdiff_t>(n)]) * real[n];
+    imagSum += (center[n] - center[-static_cast<ptrdiff_t>(n)]) * imag[n];
+  }
+  return {realSum, -imagSum};
+}
+
+bool computeSymmetric(const Kernels& kernels, uint64_t end, float gainMid, float gainSide, std::vector<float>& out,
+                      std::vector<float>& phase) {
+  if (kernels.bins == 0 || kernels.foldReals.size() != kernels.bins)
+    return false;
+
+  // Kernels are odd, so the longest ones span fftSize + 1 frames
+  const size_t maxLength = *std::max_element(kernels.lengths.begin(), kernels.lengths.end());
+  if (end < maxLength)
+    return false;
+
+  // Mix once so every bin reads a linear buffer and skips the per-bin gains and ring wrap
+  static thread_local std::vector<float, AlignedAllocator<float, 32>> input;
+  input.resize(maxLength);
+  const RingBuffer::Span span = ring.latest(end, maxLength);
+  mixSpan<false>(span, gainMid, gainSide, nullptr, input.data());
+  if (!ring.valid(span.begin))
+    return false;
+
+  out.resize(kernels.bins);
+  phase.resize(kernels.bins);
+
+  // Kernels end at the newest sample like in compute(); the buffer is thread_local to this caller
+  const float* newest = input.data() + maxLength - 1;
+  forEachBin(kernels, [&, newest](size_t k) {
+    const size_t half = kernels.foldReals[k].size() - 1;
+    auto [realSum, imagSum] = foldDot(newest - half, kernels.foldReals[k].data(), kernels.foldImags[k].data(), half);
+    out[k] = std::sqrt(realSum * realSum + imagSum * imagSum) * 2.f;
+    phase[k] = std::atan2(imagSum, realSum);
+  });
+  return true;
+}
+
+bool computeSparse(const Kernels& kernels, uint64_t end, float gainMid, float gainSide, fftwf_plan plan, float* in,
+                   fftwf_complex* spectrum, std::vector<float>& out, std::vector<float>& phase) {
+  // The plans may have been rebuilt for another size before the kernels were
+  const size_t size = kernels.sparseSize;
+  if (size == 0 || size != FFT::window->coeffs.size() || kernels.sparse.size() != kernels.bins || !plan)
+    return false;
+  if (end < size)
+    return false;
+
+  // One unwindowed transform of the newest size frames, the kernels carry their own envelopes
+  const RingBuffer::Span span = ring.latest(end, size);
+  mixSpan<false>(span, gainMid, gainSide, nullptr, in);
+  if (!ring.valid(span.begin))
+    return false;
+  fftwf_execute_dft_r2c(plan, in, spectrum);
+
+  // Split into real/imaginary planes so the kernels can gather them
+  const size_t half = size / 2 + 1;
+  static thread_local std::vector<float, AlignedAllocator<float, 32>> re, im;
+  re.resize(half);
+  im.resize(half);
+  for (size_t j = 0; j < half; j++) {
+    re[j] = spectrum[j][0];
+    im[j] = spectrum[j][1];
+  }
+
+  out.resize(kernels.bins);
+  phase.resize(kernels.bins);
+
+  // The planes are thread_local to this caller, workers get them through the capture
+  const float* xre = re.data();
+  const float* xim = im.data();
+  forEachBin(kernels, [&, xre, xim](size_t k) {
+    const SparseKernel& kernel = kernels.sparse[k];
+    const size_t count = kernel.index.size();
+    size_t n = 0;
+    float realSum = 0.f;
+    float imagSum = 0.f;
+
+#ifdef HAVE_AVX2
+    __m256 realVec = _mm256_setzero_ps();
+    __m256 imagVec = _mm256_setzero_ps();
+    for (; n + 8 <= count; n += 8) {
+      __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(kernel.index.data() + n));
+      __m256 xr = _mm256_i32gather_ps(xre, idx, 4);
+      __m256 xi = _mm256_i32gather_ps(xim, idx, 4);
+      realVec = _mm256_fmadd_ps(xr, _mm256_loadu_ps(kernel.a.data() + n), realVec);
+      realVec = _mm256_fmadd_ps(xi, _mm256_loadu_ps(kernel.b.data() + n), realVec);
+      imagVec = _mm256_fmadd_ps(xr, _mm256_loadu_ps(kernel.c.data() + n), imagVec);
+      imagVec = _mm256_fmadd_ps(xi, _mm256_loadu_ps(kernel.d.data() + n), imagVec);
+    }
+    realSum = avx2_reduce_add_ps(realVec);
+    imagSum = avx2_reduce_add_ps(imagVec);
+#endif
+    for (; n < count; n++) {
+      const int32_t j = kernel.index[n];
+      realSum += xre[j] * kernel.a[n] + xim[j] * kernel.b[n];
+      imagSum += xre[j] * kernel.c[n] + xim[j] * kernel.d[n];
+    }
+
+    out[k] = std::sqrt(realSum * realSum + imagSum * imagSum) * 2.f;
+    phase[k] = std::atan2(imagSum, realSum);
+  });
+  return true;
+}
+} // namespace ConstantQ
+
+namespace FFT {
+
+// FFTW plans and buffers
+std::mutex mutexMid;
+std::mutex mutexSide;
+std::array<fftwf_plan, batchLevels> mid;
+fftwf_plan side;
+float* inMid;
+float* inSide;
+fftwf_complex* outMid;
+fftwf_complex* outSide;
+std::array<fftwf_plan, batchLevels> packed;
+fftwf_complex* packedData;
+
+// Whether packedData and packed were created for the current plans; written with both FFT mutexes held
+std::atomic<bool> packedActive {false};
+
+// Settings the current plans and window table were made for, compared by recreatePlans()
+int plannedSize = 0;
+bool plannedCQT = false;
+float plannedSampleRate = 0.0f;
+std::string plannedWindow;
+std::string plannedPlanner;
+std::string plannedEngine;
+
+// Transform cost, read back by reportTiming()
+std::atomic<uint64_t> timingNanos {0};
+std::atomic<uint64_t> timingFrames {0};
+
+// Analysis frames waiting for the spectrogram, oldest at columnsHead
+std::mutex columnsMutex;
+std::array<Column, maxColumns> columns;
+size_t columnsHead = 0;
+size_t columnsCount = 0;
+// Frames dropped or handed back by the consumer; their buffers are reused by takeColumn()
+std::vector<Column> spareColumns;
+
+// Window tables keyed by (size, type), at most maxWindows; only touched while both FFT mutexes are held
+std::map<std::pair<int, std::string>, Window> windowCache;
+const Window* window = nullptr;
+
+Window makeWindow(int size, const std::string& type) {
+  Window w;
+  w.coeffs.resize(size);
+
+  // Periodic windows (DFT-even), so overlapping frames sum without a seam
+  const double step = 2.0 * M_PI / size;
+  auto cosineSum = [&](std::initializer_list<double> a) {
+    for (int n = 0; n < size; n++) {
+      double sum = 0.0;
+      double sign = 1.0;
+      int k = 0;
+      for (double ak : a) {
+        sum += sign * ak * std::cos(step * k * n);
+        sign = -sign;
+        k++;
+      }
+      w.coeffs[n] = static_cast<float>(sum);
+    }
+  };
+
+  if (type == "blackman_harris") {
+    cosineSum({0.35875, 0.48829, 0.14128, 0.01168});
+  } else if (type == "flattop") {
+    cosineSum({0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368});
+  } else if (type == "kaiser") {
+    // Symmetric window of size + 1 with the last point dropped is the periodic form
+    std::vector<float> kaiser = FIR::kaiser_window(size + 1, kaiserBeta);
+    std::copy_n(kaiser.begin(), size, w.coeffs.begin());
+  } else {
+    if (type != "hann")
+      logWarnAt(std::source_location::current(), "Unknown FFT window '{}', using hann", type);
+    cosineSum({0.5, 0.5});
+  }
+
+  w.gain = std::accumulate(w.coeffs.begin(), w.coeffs.end(), 0.0f);
+  return w;
+}
+
+void selectWindow() {
+  auto key = std::make_pair(Config::options.fft.size, Config::options.fft.window);
+  auto it = windowCache.find(key);
+  if (it == windowCache.end()) {
+    // The current table is being replaced, so nothing still points into the cache
+    if (windowCache.size() >= maxWindows)
+      windowCache.clear();
+    it = windowCache.emplace(key, makeWindow(key.first, key.second)).first;
+  }
+  window = &it->second;
+  plannedWindow = key.second;
+}
+
+/**
+ * @brief Plans for one FFT size, planned against scratch or live buffers of matching alignment.
+ */
+struct PlanSet {
+  std::array<fftwf_plan, batchLevels> mid {};
+  fftwf_plan side = nullptr;
+  std::array<fftwf_plan, batchLevels> packed {};
+  bool withPacked = false;
+
+  bool complete() const {
+    auto all = [](const std::array<fftwf_plan, batchLevels>& plans) {
+      return std::none_of(plans.begin(), plans.end(), [](fftwf_plan p) { return !p; });
+    };
+    return side && all(mid) && (!withPacked || all(packed));
+  }
+};
+
+std::mutex plannerMutex;
+
+// Background planning request, see requestPlanning()
+std::mutex requestMutex;
+std::condition_variable_any requestCv;
+bool requestPending = false;
+int requestSize = 0;
+unsigned requestFlags = 0;
+bool requestPacked = false;
+uint64_t requestGeneration = 0;
+
+// Bumped whenever the live plans are rebuilt so stale background results are discarded.
+// Guarded by mutexMid and mutexSide.
+uint64_t generation = 0;
+
+std::jthread plannerThread;
+
+std::string wisdomPath() { return expandUserPath("~/.config/pulse-visualizer/fftw_wisdom"); }
+
+unsigned plannerFlags() {
+  if (Config::options.fft.planner == "patient")
+    return FFTW_PATIENT;
+  if (Config::options.fft.planner == "measure")
+    return FFTW_MEASURE;
+  return FFTW_ESTIMATE;
+}
+
+// Caller must hold plannerMutex; complex is only needed (and planned in place) for the packed engine
+PlanSet makePlans(int size, float* in, fftwf_complex* out, fftwf_complex* complex, unsigned flags) {
+  const int bins = size / 2 + 1;
+  PlanSet set;
+
+  // One plan per power-of-two batch, all laid out as consecutive frames in the buffers
+  for (size_t b = 0; b < batchLevels; b++)
+    set.mid[b] = fftwf_plan_many_dft_r2c(1, &size, 1 << b, in, nullptr, 1, size, out, nullptr, 1, bins, flags);
+  set.side = fftwf_plan_dft_r2c_1d(size, in, out, flags);
+
+  if (complex) {
+    set.withPacked = true;
+    for (size_t b = 0; b < batchLevels; b++)
+      set.packed[b] = fftwf_plan_many_dft(1, &size, 1 << b, complex, nullptr, 1, size, complex, nullptr, 1, size,
+                                          FFTW_FORWARD, flags);
+  }
+  return set;
+}
+
+// Caller must hold plannerMutex
+void destroyPlans(PlanSet& set) {
+  for (auto& plan : set.mid) {
+    if (plan) {
+      fftwf_destroy_plan(plan);
+      plan = nullptr;
+    }
+  }
+  if (set.side) {
+    fftwf_destroy_plan(set.side);
+    set.side = nullptr;
+  }
+  for (auto& plan : set.packed) {
+    if (plan) {
+      fftwf_destroy_plan(plan);
+      plan = nullptr;
+    }
+  }
+}
+
+void requestPlanning(int size, unsigned flags, bool withPacked) {
+  {
+    std::lock_guard<std::mutex> lock(requestMutex);
+    requestPending = true;
+    requestSize = size;
+    requestFlags = flags;
+    requestPacked = withPacked;
+    requestGeneration = generation;
+  }
+  requestCv.notify_one();
+}
+
+void plannerMain(std::stop_token stoken) {
+  while (true) {
+    int size;
+    unsigned flags;
+    bool withPacked;
+    uint64_t gen;
+    {
+      std::unique_lock<std::mutex> lock(requestMutex);
+      if (!requestCv.wait(lock, stoken, [] { return requestPending; }))
+        return;
+      requestPending = false;
+      size = requestSize;
+      flags = requestFlags;
+      withPacked = requestPacked;
+      gen = requestGeneration;
+    }
+
+    // Measuring overwrites the arrays, so plan on scratch buffers the live threads never touch
+    const int bins = size / 2 + 1;
+    float* scratchIn = fftwf_alloc_real(size * maxBatch);
+    fftwf_complex* scratchOut = fftwf_alloc_complex(bins * maxBatch);
+    fftwf_complex* scratchComplex = withPacked ? fftwf_alloc_complex(size * maxBatch) : nullptr;
+    if (!scratchIn || !scratchOut || (withPacked && !scratchComplex)) {
+      logWarnAt(std::source_location::current(), "Failed to allocate FFTW planning buffers");
+      fftwf_free(scratchIn);
+      fftwf_free(scratchOut);
+      fftwf_free(scratchComplex);
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    PlanSet set;
+    {
+      std::lock_guard<std::mutex> lock(plannerMutex);
+      set = makePlans(size, scratchIn, scratchOut, scratchComplex, flags);
+    }
+    fftwf_free(scratchIn);
+    fftwf_free(scratchOut);
+    fftwf_free(scratchComplex);
+
+    // Swap the plans in unless the size changed again while we were planning
+    bool swapped = false;
+    if (set.complete()) {
+      std::lock_guard<std::mutex> lockMid(mutexMid);
+      std::lock_guard<std::mutex> lockSide(mutexSide);
+      if (gen == generation) {
+        std::swap(set.mid, mid);
+        std::swap(set.side, side);
+        std::swap(set.packed, packed);
+        swapped = true;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(plannerMutex);
+    destroyPlans(set);
+    if (swapped) {
+      logDebug("FFTW planned size {} in {:.0f} ms", size,
+               std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count());
+      if (!fftwf_export_wisdom_to_filename(wisdomPath().c_str()))
+        logWarnAt(std::source_location::current(), "Failed to save FFTW wisdom to {}", wisdomPath());
+    }
+  }
+}
+
+/**
+ * @brief Allocate buffers and create plans for the configured size
+ *
+ * Uses accumulated wisdom when it covers the configured planner rigor; otherwise starts with
+ * estimated plans and lets the background planner replace them.
+ */
+void createPlans() {
+  int size = Config::options.fft.size;
+  int bins = size / 2 + 1;
+  // One extra window so the packed engine can stage the side channel next to the mid hops
+  inMid = fftwf_alloc_real(size * (maxBatch + 1));
+  inSide = fftwf_alloc_real(size);
+  outMid = fftwf_alloc_complex(bins * maxBatch);
+  outSide = fftwf_alloc_complex(bins);
+  const bool withPacked = Config::options.fft.engine == "packed";
+  packedData = withPacked ? fftwf_alloc_complex(size * maxBatch) : nullptr;
+  generation++;
+
+  const unsigned flags = plannerFlags();
+  bool fromWisdom = false;
+  PlanSet set;
+  {
+    std::lock_guard<std::mutex> lock(plannerMutex);
+    if (flags != FFTW_ESTIMATE) {
+      set = makePlans(size, inMid, outMid, packedData, flags | FFTW_WISDOM_ONLY);
+      fromWisdom = set.complete();
+      if (!fromWisdom)
+        destroyPlans(set);
+    }
+    if (!fromWisdom)
+      set = makePlans(size, inMid, outMid, packedData, FFTW_ESTIMATE);
+  }
+  mid = set.mid;
+  side = set.side;
+  packed = set.packed;
+  packedActive = withPacked && packedData && set.complete();
+
+  if (!inMid || !inSide || !outMid || !outSide || (withPacked && !packedData) || !set.complete())
+    logWarnAt(std::source_location::current(), "Failed to allocate FFTW buffers");
+
+  if (flags != FFTW_ESTIMATE && !fromWisdom)
+    requestPlanning(size, flags, withPacked);
+
+  timingNanos = 0;
+  timingFrames = 0;
+
+  plannedSize = size;
+  plannedCQT = Config::options.fft.cqt.enabled;
+  plannedSampleRate = Config::options.audio.sample_rate;
+  plannedPlanner = Config::options.fft.planner;
+  plannedEngine = Config::options.fft.engine;
+  selectWindow();
+}
+
+// Caller must hold plannerMutex
+void releasePlans() {
+  packedActive = false;
+  PlanSet set {mid, side, packed};
+  destroyPlans(set);
+  mid = {};
+  side = nullptr;
+  packed = {};
+
+  fftwf_free(inMid);
+  fftwf_free(inSide);
+  fftwf_free(outMid);
+  fftwf_free(outSide);
+  fftwf_free(packedData);
+  inMid = nullptr;
+  inSide = nullptr;
+  outMid = nullptr;
+  outSide = nullptr;
+  packedData = nullptr;
+}
+
+void init() {
+  {
+    std::lock_guard<std::mutex> lock(plannerMutex);
+    if (fftwf_import_wisdom_from_filename(wisdomPath().c_str()))
+      logDebug("Loaded FFTW wisdom from {}", wisdomPath());
+  }
+
+  if (!plannerThread.joinable())
+    plannerThread = std::jthread(plannerMain);
+
+  createPlans();
+}
+
+void cleanup() {
+  if (plannerThread.joinable()) {
+    plannerThread.request_stop();
+    plannerThread.join();
+  }
+
+  std::lock_guard<std::mutex> lock(plannerMutex);
+  releasePlans();
+}
+
+bool recreatePlans() {
+  // Compare against what createPlans() last ran with, so the first edit after launch is seen too
+  const bool plansChanged = plannedSize != Config::options.fft.size ||
+                            plannedCQT != Config::options.fft.cqt.enabled ||
+                            plannedSampleRate != Config::options.audio.sample_rate ||
+                            plannedPlanner != Config::options.fft.planner ||
+                            plannedEngine != Config::options.fft.engine;
+  if (!plansChanged && plannedWindow == Config::options.fft.window) [[likely]]
+    return false;
+
+  std::lock_guard<std::mutex> lockMid(mutexMid);
+  std::lock_guard<std::mutex> lockSide(mutexSide);
+
+  if (plansChanged) {
+    {
+      std::lock_guard<std::mutex> lock(plannerMutex);
+      releasePlans();
+    }
+    createPlans();
+  } else {
+    selectWindow();
+  }
+
+  return true;
+}
+
+void prepareInput(const RingBuffer::Span& span, float gainMid, float gainSide, float* out) {
+  mixSpan<true>(span, gainMid, gainSide, window->coeffs.data(), out);
+}
+
+void execute(size_t frames) {
+  size_t done = 0;
+  for (size_t b = batchLevels; b-- > 0;) {
+    const size_t batch = size_t(1) << b;
+    while (frames - done >= batch) {
+      fftwf_execute_dft_r2c(mid[b], inMid + done * Config::options.fft.size,
+                            outMid + done * (Config::options.fft.size / 2 + 1));
+      done += batch;
+    }
+  }
+}
+
+/**
+ * @brief Keep a frame's buffers for reuse, unless enough are kept already; caller holds columnsMutex
+ */
+static void recycle(Column&& column) {
+  if (column.magnitude.capacity() == 0 || spareColumns.size() > maxColumns)
+    return;
+  if (spareColumns.capacity() == 0)
+    spareColumns.reserve(maxColumns + 1);
+  spareColumns.push_back(std::move(column));
+}
+
+Column takeColumn() {
+  std::lock_guard<std::mutex> lock(columnsMutex);
+  if (spareColumns.empty())
+    return {};
+  Column column = std::move(spareColumns.back());
+  spareColumns.pop_back();
+  return column;
+}
+
+bool packedEngine() { return packedActive.load(std::memory_order_relaxed); }
+
+void pack(size_t count) {
+  const size_t size = Config::options.fft.size;
+  const size_t pairs = (count + 1) / 2;
+  for (size_t p = 0; p < pairs; p++) {
+    const float* a = inMid + 2 * p * size;
+    const float* b = 2 * p + 1 < count ? a + size : nullptr;
+    float* z = reinterpret_cast<float*>(packedData + p * size);
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    for (; i + 8 <= size; i += 8) {
+      __m256 re = _mm256_loadu_ps(a + i);
+      __m256 im = b ? _mm256_loadu_ps(b + i) : _mm256_setzero_ps();
+      __m256 lo = _mm256_unpacklo_ps(re, im);
+      __m256 hi = _mm256_unpackhi_ps(re, im);
+      _mm256_storeu_ps(z + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+      _mm256_storeu_ps(z + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+#endif
+    for (; i < size; i++) {
+      z[2 * i] = a[i];
+      z[2 * i + 1] = b ? b[i] : 0.f;
+    }
+  }
+
+  size_t done = 0;
+  for (size_t b = batchLevels; b-- > 0;) {
+    const size_t batch = size_t(1) << b;
+    while (pairs - done >= batch) {
+      fftwf_execute_dft(packed[b], packedData + done * size, packedData + done * size);
+      done += batch;
+    }
+  }
+}
+
+void unpack(size_t pair, fftwf_complex* a, fftwf_complex* b) {
+  const size_t size = Config::options.fft.size;
+  const fftwf_complex* z = packedData + pair * size;
+
+  // With z = x + iy for real x and y, X[k] = (Z[k] + conj(Z[N-k])) / 2 and Y[k] = (Z[k] - conj(Z[N-k])) / 2i
+  for (size_t k = 0; k <= size / 2; k++) {
+    const fftwf_complex& zk = z[k];
+    const fftwf_complex& zn = z[k == 0 ? 0 : size - k];
+    a[k][0] = 0.5f * (zk[0] + zn[0]);
+    a[k][1] = 0.5f * (zk[1] - zn[1]);
+    if (b) {
+      b[k][0] = 0.5f * (zk[1] + zn[1]);
+      b[k][1] = 0.5f * (zn[0] - zk[0]);
+    }
+  }
+}
+
+// Render time of the last visualizer that asked for phase, in steady_clock ticks
+std::atomic<int64_t> phaseRequest {std::numeric_limits<int64_t>::min()};
+
+void requestPhase() { phaseRequest = std::chrono::steady_clock::now().time_since_epoch().count(); }
+
+bool phaseNeeded() {
+  const auto last = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(phaseRequest.load()));
+  return std::chrono::steady_clock::now() - last < 1s;
+}
+
+// Minimax coefficients for atan(a) on [0, 1], max error ~1e-5 rad
+constexpr float atanC0 = 0.99997726f;
+constexpr float atanC1 = -0.33262347f;
+constexpr float atanC2 = 0.19354346f;
+constexpr float atanC3 = -0.11643287f;
+constexpr float atanC4 = 0.05265332f;
+constexpr float atanC5 = -0.01172120f;
+
+/**
+ * @brief Polynomial atan2, scalar counterpart of the AVX2 version below
+ */
+static inline float fastAtan2(float y, float x) {
+  const float ax = std::abs(x);
+  const float ay = std::abs(y);
+  const float mx = std::max(ax, ay);
+  const float a = mx > 0.f ? std::min(ax, ay) / mx : 0.f;
+  const float s = a * a;
+  float r = ((((atanC5 * s + atanC4) * s + atanC3) * s + atanC2) * s + atanC1) * s + atanC0;
+  r *= a;
+  if (ay > ax)
+    r = static_cast<float>(M_PI_2) - r;
+  if (x < 0.f)
+    r = static_cast<float>(M_PI) - r;
+  return std::copysign(r, y);
+}
+
+#ifdef HAVE_AVX2
+static inline __m256 fastAtan2(__m256 y, __m256 x) {
+  const __m256 signMask = _mm256_set1_ps(-0.f);
+  const __m256 ax = _mm256_andnot_ps(signMask, x);
+  const __m256 ay = _mm256_andnot_ps(signMask, y);
+  const __m256 mx = _mm256_max_ps(ax, ay);
+  const __m256 nonZero = _mm256_cmp_ps(mx, _mm256_setzero_ps(), _CMP_GT_OQ);
+  const __m256 a = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(ax, ay), mx), nonZero);
+  const __m256 s = _mm256_mul_ps(a, a);
+
+  __m256 r = _mm256_fmadd_ps(_mm256_set1_ps(atanC5), s, _mm256_set1_ps(atanC4));
+  r = _mm256_fmadd_ps(r, s, _mm256_set1_ps(atanC3));
+  r = _mm256_fmadd_ps(r, s, _mm256_set1_ps(atanC2));
+  r = _mm256_fmadd_ps(r, s, _mm256_set1_ps(atanC1));
+  r = _mm256_fmadd_ps(r, s, _mm256_set1_ps(atanC0));
+  r = _mm256_mul_ps(r, a);
+
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(M_PI_2), r), _mm256_cmp_ps(ay, ax, _CMP_GT_OQ));
+  r = _mm256_blendv_ps(r, _mm256_sub_ps(_mm256_set1_ps(M_PI), r), _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ));
+  return _mm256_or_ps(r, _mm256_and_ps(y, signMask));
+}
+#endif
+
+void toSpectrum(const fftwf_complex* out, size_t size, float* magnitude, float* phase) {
+  const float scale = 1.f / window->gain;
+  const size_t bins = size / 2 + 1;
+  const float* data = reinterpret_cast<const float*>(out);
+  size_t i = 0;
+
+#ifdef HAVE_AVX2
+  // Bins 1 .. size/2 - 1 carry both the positive and negative frequency halves
+  const __m256 vScale = _mm256_set1_ps(2.f * scale);
+  for (i = 1; i + 8 < bins; i += 8) {
+    __m256 v0 = _mm256_loadu_ps(data + 2 * i);
+    __m256 v1 = _mm256_loadu_ps(data + 2 * i + 8);
+    __m256 re = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 im = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+    re = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), _MM_SHUFFLE(3, 1, 2, 0)));
+    im = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im), _MM_SHUFFLE(3, 1, 2, 0)));
+    __m256 mag = _mm256_sqrt_ps(_mm256_fmadd_ps(re, re, _mm256_mul_ps(im, im)));
+    _mm256_storeu_ps(magnitude + i, _mm256_mul_ps(mag, vScale));
+    if (phase)
+      _mm256_storeu_ps(phase + i, fastAtan2(im, re));
+  }
+  magnitude[0] = std::sqrt(out[0][0] * out[0][0] + out[0][1] * out[0][1]) * scale;
+  if (phase)
+    phase[0] = fastAtan2(out[0][1], out[0][0]);
+#endif
+
+  for (; i < bins; i++) {
+    float mag = std::sqrt(out[i][0] * out[i][0] + out[i][1] * out[i][1]) * scale;
+    if (i != 0 && i != size / 2)
+      mag *= 2.f;
+    magnitude[i] = mag;
+    if (phase)
+      phase[i] = fastAtan2(out[i][1], out[i][0]);
+  }
+}
+
+void recordTiming(std::chrono::steady_clock::duration elapsed, size_t spectra) {
+  timingNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  timingFrames += spectra;
+}
+
+void reportTiming() {
+  static auto lastReport = std::chrono::steady_clock::now();
+  auto now = std::chrono::steady_clock::now();
+  if (now - lastReport < 10s)
+    return;
+  lastReport = now;
+
+  const uint64_t frames = timingFrames.exchange(0);
+  const uint64_t nanos = timingNanos.exchange(0);
+  if (frames)
+    logDebug("FFT engine '{}': {:.1f} us per spectrum over {} spectra", Config::options.fft.engine,
+             nanos / 1000.0 / frames, frames);
+}
+
+void publish(Column&& column) {
+  std::lock_guard<std::mutex> lock(columnsMutex);
+  if (columnsCount == maxColumns) {
+    recycle(std::move(columns[columnsHead]));
+    columnsHead = (columnsHead + 1) % maxColumns;
+    columnsCount--;
+  }
+  columns[(columnsHead + columnsCount) % maxColumns] = std::move(column);
+  columnsCount++;
+}
+
+bool popColumn(Column& column) {
+  std::lock_guard<std::mutex> lock(columnsMutex);
+  if (columnsCount == 0)
+    return false;
+  recycle(std::move(column));
+  column = std::move(columns[columnsHead]);
+  columnsHead = (columnsHead + 1) % maxColumns;
+  columnsCount--;
+  return true;
+}
+} // namespace FFT
+
+namespace Smoothing {
+
+void process(State& state, const std::vector<float>& raw, std::vector<float>& out, float dt) {
+  const size_t bins = raw.size();
+
+  // Reseed on the first frame or when the bin count changes (FFT size, CQT rebuild)
+  if (out.size() != bins || state.level.size() != bins) {
+    out = raw;
+    state.level.resize(bins);
+    state.held.assign(bins, 0.0f);
+    for (size_t i = 0; i < bins; ++i)
+      state.level[i] = 20.f * log10f(raw[i] + FLT_EPSILON);
+    return;
+  }
+
+  bool hovering =
+      !Config::options.fft.sphere.enabled && !Config::options.phosphor.enabled && Config::options.fft.cursor;
+  auto window = VisualizerRegistry::find("spectrum_analyzer").lock();
+  hovering = hovering && window->hovering;
+  const float riseSpeed = Config::options.fft.smoothing.rise_speed * dt;
+  const float fallSpeed =
+      (hovering ? Config::options.fft.smoothing.hover_fall_speed : Config::options.fft.smoothing.fall_speed) * dt;
+  const float holdTime = Config::options.fft.smoothing.hold_time;
+
+  // A clamped step moves the level by exactly one speed, i.e. a fixed linear gain this frame
+  const float riseGain = powf(10.f, riseSpeed / 20.f);
+  const float fallGain = powf(10.f, -fallSpeed / 20.f);
+
+  float* level = state.level.data();
+  float* held = state.held.data();
+  size_t i = 0;
+
+#ifdef HAVE_AVX2
+  const __m256 riseVec = _mm256_set1_ps(riseSpeed);
+  const __m256 fallVec = _mm256_set1_ps(fallSpeed);
+  const __m256 negFallVec = _mm256_set1_ps(-fallSpeed);
+  const __m256 riseGainVec = _mm256_set1_ps(riseGain);
+  const __m256 fallGainVec = _mm256_set1_ps(fallGain);
+  const __m256 holdVec = _mm256_set1_ps(holdTime);
+  const __m256 dtVec = _mm256_set1_ps(dt);
+  const __m256 epsVec = _mm256_set1_ps(FLT_EPSILON);
+  const __m256 dbScaleVec = _mm256_set1_ps(20.0f);
+  const __m256 signMask = _mm256_set1_ps(-0.f);
+  for (; i + 7 < bins; i += 8) {
+    const __m256 cur = _mm256_loadu_ps(&raw[i]);
+    const __m256 prevOut = _mm256_loadu_ps(&out[i]);
+    const __m256 prev = _mm256_load_ps(level + i);
+    const __m256 heldVec = _mm256_load_ps(held + i);
+
+    const __m256 curDB = _mm256_mul_ps(_mm256_log10_ps(_mm256_add_ps(cur, epsVec)), dbScaleVec);
+    const __m256 diff = _mm256_sub_ps(curDB, prev);
+    const __m256 isRise = _mm256_cmp_ps(diff, _mm256_setzero_ps(), _CMP_GT_OQ);
+    const __m256 reached =
+        _mm256_cmp_ps(_mm256_andnot_ps(signMask, diff), _mm256_blendv_ps(fallVec, riseVec, isRise), _CMP_LE_OQ);
+
+    __m256 newDB = _mm256_add_ps(prev, _mm256_blendv_ps(negFallVec, riseVec, isRise));
+    __m256 newOut = _mm256_fmsub_ps(_mm256_add_ps(prevOut, epsVec),
+                                    _mm256_blendv_ps(fallGainVec, riseGainVec, isRise), epsVec);
+    newDB = _mm256_blendv_ps(newDB, curDB, reached);
+    newOut = _mm256_blendv_ps(newOut, cur, reached);
+
+    // Bins that fell within the hold time keep their level
+    const __m256 frozen = _mm256_andnot_ps(isRise, _mm256_cmp_ps(heldVec, holdVec, _CMP_LT_OQ));
+    newDB = _mm256_blendv_ps(newDB, prev, frozen);
+    newOut = _mm256_blendv_ps(newOut, prevOut, frozen);
+    const __m256 newHeld = _mm256_andnot_ps(isRise, _mm256_add_ps(heldVec, _mm256_and_ps(frozen, dtVec)));
+
+    _mm256_store_ps(level + i, newDB);
+    _mm256_store_ps(held + i, newHeld);
+    _mm256_storeu_ps(&out[i], newOut);
+  }
+#endif
+
+  for (; i < bins; ++i) {
+    const float curDB = 20.f * log10f(raw[i] + FLT_EPSILON);
+    const float diff = curDB - level[i];
+    if (diff > 0.f) {
+      held[i] = 0.f;
+      if (diff <= riseSpeed) {
+        level[i] = curDB;
+        out[i] = raw[i];
+      } else {
+        level[i] += riseSpeed;
+        out[i] = (out[i] + FLT_EPSILON) * riseGain - FLT_EPSILON;
+      }
+    } else if (held[i] < holdTime) {
+      held[i] += dt;
+    } else if (-diff <= fallSpeed) {
+      level[i] = curDB;
+      out[i] = raw[i];
+    } else {
+      level[i] -= fallSpeed;
+      out[i] = (out[i] + FLT_EPSILON) * fallGain - FLT_EPSILON;
+    }
+  }
+}
+
+} // namespace Smoothing
+
+namespace Accumulator {
+
+State mid;
+State side;
+
+std::shared_ptr<const Curves> current(const State& state) { return state.published.load(std::memory_order_acquire); }
+
+void process(State& state, const std::vector<float>& raw, float dt) {
+  const auto& options = Config::options.fft.accumulator;
+  const bool exponential = options.average == "exponential";
+  const bool linear = options.average == "linear";
+  const size_t bins = raw.size();
+
+  if (!options.peak_hold)
+    state.peak.clear();
+  if (!exponential)
+    state.ema.clear();
+  if (!linear) {
+    state.history.clear();
+    state.sum.clear();
+    state.frames = 0;
+  }
+
+  if (!options.peak_hold && !exponential && !linear)
+    return;
+
+  if (options.peak_hold) {
+    if (state.peak.size() != bins) {
+      state.peak.assign(raw.begin(), raw.end());
+    } else {
+      // Held peaks fall at a constant rate in dB
+      const float decay = powf(10.f, -options.peak_decay * dt / 20.f);
+      size_t i = 0;
+#ifdef HAVE_AVX2
+      const __m256 decayVec = _mm256_set1_ps(decay);
+      for (; i + 7 < bins; i += 8) {
+        const __m256 held = _mm256_mul_ps(_mm256_load_ps(&state.peak[i]), decayVec);
+        _mm256_store_ps(&state.peak[i], _mm256_max_ps(_mm256_loadu_ps(&raw[i]), held));
+      }
+#endif
+      for (; i < bins; ++i)
+        state.peak[i] = std::max(raw[i], state.peak[i] * decay);
+    }
+  }
+
+  // Averages are taken over power so quiet frames weigh in correctly, then reported as magnitude
+  if (exponential) {
+    if (state.ema.size() != bins) {
+      state.ema.resize(bins);
+      for (size_t i = 0; i < bins; ++i)
+        state.ema[i] = raw[i] * raw[i];
+    } else {
+      const float alpha = 1.f - expf(-dt / std::max(options.average_time, FLT_EPSILON));
+      size_t i = 0;
+#ifdef HAVE_AVX2
+      const __m256 alphaVec = _mm256_set1_ps(alpha);
+      for (; i + 7 < bins; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&raw[i]);
+        const __m256 avg = _mm256_load_ps(&state.ema[i]);
+        _mm256_store_ps(&state.ema[i], _mm256_fmadd_ps(alphaVec, _mm256_fmsub_ps(x, x, avg), avg));
+      }
+#endif
+      for (; i < bins; ++i)
+        state.ema[i] += alpha * (raw[i] * raw[i] - state.ema[i]);
+    }
+  } else if (linear) {
+    const size_t frames = static_cast<size_t>(std::max(options.average_frames, 1));
+    if (state.sum.size() != bins || state.frames != frames) {
+      state.history.assign(frames * bins, 0.f);
+      state.sum.assign(bins, 0.f);
+      state.frames = frames;
+      state.cursor = 0;
+      state.filled = 0;
+    }
+
+    // Replace the oldest frame in the history and update the running sum with the difference
+    float* row = state.history.data() + state.cursor * bins;
+    float* sum = state.sum.data();
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    // Rows start at multiples of bins, so only the first one is guaranteed to be aligned
+    for (; i + 7 < bins; i += 8) {
+      const __m256 x = _mm256_loadu_ps(&raw[i]);
+      const __m256 power = _mm256_mul_ps(x, x);
+      _mm256_store_ps(sum + i, _mm256_add_ps(_mm256_load_ps(sum + i), _mm256_sub_ps(power, _mm256_loadu_ps(row + i))));
+      _mm256_storeu_ps(row + i, power);
+    }
+#endif
+    for (; i < bins; ++i) {
+      const float power = raw[i] * raw[i];
+      sum[i] += power - row[i];
+      row[i] = power;
+    }
+
+    state.filled = std::min(state.filled + 1, frames);
+    if (++state.cursor == frames) {
+      state.cursor = 0;
+
+      // Resum once per pass over the history so rounding errors of the running sum cannot build up
+      std::fill(state.sum.begin(), state.sum.end(), 0.f);
+      for (size_t f = 0; f < frames; ++f) {
+        const float* past = state.history.data() + f * bins;
+        for (size_t j = 0; j < bins; ++j)
+          sum[j] += past[j];
+      }
+    }
+  }
+}
+
+void publish(State& state) {
+  if (state.peak.empty() && state.ema.empty() && state.sum.empty()) {
+    if (!current(state)->peak.empty() || !current(state)->average.empty())
+      state.published.store(std::make_shared<const Curves>(), std::memory_order_release);
+    return;
+  }
+
+  // The spare snapshot is only shared while a renderer still holds it from before the last swap
+  std::shared_ptr<Curves>& curves = state.snapshots[state.spare];
+  if (!curves || curves.use_count() > 1)
+    curves = std::make_shared<Curves>();
+
+  curves->peak.assign(state.peak.begin(), state.peak.end());
+
+  // Averages are kept as power and reported as magnitude
+  if (!state.ema.empty()) {
+    curves->average.resize(state.ema.size());
+    for (size_t i = 0; i < state.ema.size(); ++i)
+      curves->average[i] = sqrtf(state.ema[i]);
+  } else if (!state.sum.empty()) {
+    curves->average.resize(state.sum.size());
+    const float scale = 1.f / static_cast<float>(std::max<size_t>(state.filled, 1));
+    for (size_t i = 0; i < state.sum.size(); ++i)
+      curves->average[i] = sqrtf(std::max(state.sum[i] * scale, 0.f));
+  } else {
+    curves->average.clear();
+  }
+
+  state.published.store(curves, std::memory_order_release);
+  state.spare ^= 1;
+}
+
+} // namespace Accumulator
+
+namespace Pitch {
+
+// Analysis buffers and transforms, used by the main FFT thread; mutex only guards them against cleanup()
+std::mutex mutex;
+float* frame = nullptr; // Window zero-padded to twice its length, autocorrelation after the inverse transform
+fftwf_complex* spectrum = nullptr;
+fftwf_plan forward = nullptr;
+fftwf_plan inverse = nullptr;
+std::vector<float> decimated;
+std::vector<float> nsdf;
+
+// Tracker state
+float tracked = 0.f;
+float candidate = 0.f;
+int confirmations = 0;
+float lost = 0.f;
+
+// Frequency and confidence packed into one word so readers never see a torn pair
+std::atomic<uint64_t> published {0};
+
+void init() {
+  decimated.resize(window);
+  nsdf.resize(window / 2);
+  frame = fftwf_alloc_real(2 * window);
+  spectrum = fftwf_alloc_complex(window + 1);
+  if (frame && spectrum) {
+    std::lock_guard<std::mutex> lock(FFT::plannerMutex);
+    forward = fftwf_plan_dft_r2c_1d(2 * window, frame, spectrum, FFTW_ESTIMATE);
+    inverse = fftwf_plan_dft_c2r_1d(2 * window, spectrum, frame, FFTW_ESTIMATE);
+  }
+  if (!forward || !inverse)
+    logWarnAt(std::source_location::current(), "Failed to plan pitch detection");
+}
+
+void cleanup() {
+  std::lock_guard<std::mutex> lockPitch(mutex);
+  {
+    std::lock_guard<std::mutex> lock(FFT::plannerMutex);
+    if (forward)
+      fftwf_destroy_plan(forward);
+    if (inverse)
+      fftwf_destroy_plan(inverse);
+  }
+  forward = inverse = nullptr;
+  fftwf_free(frame);
+  fftwf_free(spectrum);
+  frame = nullptr;
+  spectrum = nullptr;
+}
+
+Estimate current() {
+  const uint64_t word = published.load(std::memory_order_acquire);
+  return {std::bit_cast<float>(static_cast<uint32_t>(word)), std::bit_cast<float>(static_cast<uint32_t>(word >> 32))};
+}
+
+static void publish(float frequency, float confidence) {
+  published.store(static_cast<uint64_t>(std::bit_cast<uint32_t>(frequency)) |
+                      static_cast<uint64_t>(std::bit_cast<uint32_t>(confidence)) << 32,
+                  std::memory_order_release);
+}
+
+/**
+ * @brief Pick the period from the NSDF
+ * @return Period in decimated samples and its clarity, or {0, 0} if there is none in [minLag, maxLag]
+ */
+static std::pair<float, float> findPeriod(size_t minLag, size_t maxLag) {
+  // Skip the lobe around lag 0, then take the maximum of every positive lobe as a key maximum
+  size_t tau = 1;
+  while (tau < maxLag && nsdf[tau] > 0.f)
+    tau++;
+
+  size_t keys[32];
+  size_t keyCount = 0;
+  float highest = 0.f;
+  while (tau < maxLag && keyCount < std::size(keys)) {
+    while (tau < maxLag && nsdf[tau] <= 0.f)
+      tau++;
+    size_t best = tau;
+    while (tau < maxLag && nsdf[tau] > 0.f) {
+      if (nsdf[tau] > nsdf[best])
+        best = tau;
+      tau++;
+    }
+    if (best >= minLag && best < maxLag && nsdf[best] > 0.f) {
+      keys[keyCount++] = best;
+      highest = std::max(highest, nsdf[best]);
+    }
+  }
+
+  // The first key maximum close to the highest one is the fundamental; later ones are its multiples
+  for (size_t k = 0; k < keyCount; k++) {
+    const size_t t = keys[k];
+    if (nsdf[t] < keyThreshold * highest)
+      continue;
+
+    const float a = nsdf[t - 1];
+    const float b = nsdf[t];
+    const float c = nsdf[t + 1];
+    const float denom = a - 2.f * b + c;
+    const float offset = std::abs(denom) > FLT_EPSILON ? std::clamp(0.5f * (a - c) / denom, -0.5f, 0.5f) : 0.f;
+    return {static_cast<float>(t) + offset, std::min(b - 0.25f * (a - c) * offset, 1.f)};
+  }
+  return {0.f, 0.f};
+}
+
+void process(uint64_t end, float dt) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!forward || !inverse)
+    return;
+
+  const float sampleRate = Config::options.audio.sample_rate;
+  const size_t factor = std::max<size_t>(1, static_cast<size_t>(std::lround(sampleRate / analysisRate)));
+  const float rate = sampleRate / static_cast<float>(factor);
+
+  // Box-filter decimation of the mid signal; its nulls at multiples of rate suppress most of the aliasing
+  const RingBuffer::Span span = ring.latest(end, window * factor);
+  std::fill(decimated.begin(), decimated.end(), 0.f);
+  const float scale = 1.f / static_cast<float>(factor);
+  const bool intact = ring.read(span, [&](const float* mid, const float*, size_t offset, size_t len) {
+    for (size_t i = 0; i < len; i++)
+      decimated[(offset + i) / factor] += mid[i] * scale;
+  });
+  if (!intact)
+    return;
+
+  float mean = 0.f;
+  for (float x : decimated)
+    mean += x;
+  mean /= static_cast<float>(window);
+
+  float energy = 0.f;
+  for (size_t i = 0; i < window; i++) {
+    frame[i] = decimated[i] - mean;
+    energy += frame[i] * frame[i];
+  }
+  std::fill_n(frame + window, window, 0.f);
+
+  float period = 0.f;
+  float clarity = 0.f;
+  if (energy > FLT_EPSILON) {
+    // Autocorrelation r(tau) = IFFT(|X|^2); the zero padding keeps it from wrapping around
+    fftwf_execute(forward);
+    for (size_t k = 0; k <= window; k++) {
+      spectrum[k][0] = spectrum[k][0] * spectrum[k][0] + spectrum[k][1] * spectrum[k][1];
+      spectrum[k][1] = 0.f;
+    }
+    fftwf_execute(inverse);
+
+    // nsdf(tau) = 2 r(tau) / m(tau), m(tau) = sum of x[j]^2 + x[j + tau]^2 over the overlap. The samples
+    // leaving the overlap are read back from decimated since frame now holds the autocorrelation
+    const float norm = 1.f / static_cast<float>(2 * window);
+    float m = 2.f * energy;
+    for (size_t tau = 0; tau < nsdf.size(); tau++) {
+      nsdf[tau] = m > FLT_EPSILON ? 2.f * frame[tau] * norm / m : 0.f;
+      const float head = decimated[tau] - mean;
+      const float tail = decimated[window - 1 - tau] - mean;
+      m -= head * head + tail * tail;
+    }
+
+    const float maxFreq = std::min(Config::options.fft.limits.max_freq, rate / 4.f);
+    const float minFreq = std::max(Config::options.fft.limits.min_freq, rate / static_cast<float>(nsdf.size() - 2));
+    if (maxFreq > minFreq) {
+      const size_t minLag = std::max<size_t>(2, static_cast<size_t>(rate / maxFreq));
+      const size_t maxLag = std::min(nsdf.size() - 2, static_cast<size_t>(std::ceil(rate / minFreq)));
+      std::tie(period, clarity) = findPeriod(minLag, maxLag);
+    }
+  }
+
+  // Hysteresis: a weaker match keeps a pitch than starts one, and jumps need confirming frames
+  const auto cents = [](float a, float b) { return std::abs(1200.f * log2f(a / b)); };
+  if (period > 0.f && clarity >= (tracked > 0.f ? releaseClarity : acquireClarity)) {
+    const float frequency = rate / period;
+    lost = 0.f;
+    if (tracked <= 0.f || cents(frequency, tracked) < jumpCents) {
+      tracked = frequency;
+      candidate = 0.f;
+      confirmations = 0;
+    } else {
+      if (candidate > 0.f && cents(frequency, candidate) < jumpCents) {
+        confirmations++;
+      } else {
+        candidate = frequency;
+        confirmations = 1;
+      }
+      if (confirmations >= jumpFrames) {
+        tracked = frequency;
+        candidate = 0.f;
+        confirmations = 0;
+      }
+    }
+  } else if (tracked > 0.f) {
+    lost += dt;
+    if (lost >= holdTime)
+      tracked = 0.f;
+  }
+
+  publish(tracked, tracked > 0.f ? clarity : 0.f);
+}
+
+} // namespace Pitch
+
+namespace Threads {
+
+// Thread synchronization
+Wakeup fftMainWake;
+Wakeup fftAltWake;
+Wakeup lufsWake;
+
+// Display smoothing state, shared by both FFT threads
+Smoothing::State midSmoothing;
+Smoothing::State sideSmoothing;
+
+// Audio seconds since the previous accumulated column, zero for the first one
+static float columnSeconds(uint64_t end, uint64_t& last) {
+  const uint64_t previous = last ? last : end;
+  last = end;
+  return static_cast<float>(end - previous) / Config::options.audio.sample_rate;
+}
+
+int FFTMain(std::stop_token stoken) {
+  std::stop_callback cb {stoken, [] { fftMainWake.notify(); }};
+  auto lastRun = std::chrono::steady_clock::now();
+
+  // End frame of the next analysis hop
+  uint64_t nextHop = 0;
+  // End frame of the last CQT column folded into the accumulator
+  uint64_t lastColumn = 0;
+
+  while (true) {
+    fftMainWake.wait();
     if (stoken.stop_requested())
       break;
 
-    if (Config::options.phosphor.enabled && Config::options.waveform.mode == "mono")
-      continue;
+    // Snapshot the ring head once so both paths see the same frames
+    const uint64_t end = ring.head();
+    const bool leftRight = Config::options.fft.mode == "leftright";
 
-    // Process alternative channel FFT (for stereo visualization)
+    // Process main channel FFT
     if (Config::options.fft.cqt.enabled) {
-      if (Config::options.fft.mode == "leftright") {
-        ConstantQ::compute(bufferMid, bufferSide, 0.5f, 0.5f, fftSideRaw, fftSidePhase);
+      // Pin one kernel set for the whole frame; rebuilds publish a new one in the background
+      const auto kernels = ConstantQ::current();
+      if (kernels->engine == ConstantQ::Engine::Sparse) {
+        std::lock_guard<std::mutex> lockFft(FFT::mutexMid);
+        if (!ConstantQ::computeSparse(*kernels, end, leftRight ? -0.5f : 1.0f, leftRight ? 0.5f : 0.0f, FFT::mid[0],
+                                      FFT::inMid, FFT::outMid, fftMidRaw, fftMidPhase))
+          continue;
+      } else if (kernels->engine == ConstantQ::Engine::Multirate) {
+        static ConstantQ::Multirate state;
+        ConstantQ::computeMultirate(*kernels, state, end, leftRight ? -0.5f : 1.0f, leftRight ? 0.5f : 0.0f, fftMidRaw,
+                                    fftMidPhase);
+      } else if (kernels->engine == ConstantQ::Engine::Sliding) {
+        static ConstantQ::Sliding state;
+        ConstantQ::computeSliding(*kernels, state, end, leftRight ? -0.5f : 1.0f, leftRight ? 0.5f : 0.0f, fftMidRaw,
+                                  fftMidPhase);
+      } else if (kernels->engine == ConstantQ::Engine::Symmetric) {
+        if (!ConstantQ::computeSymmetric(*kernels, end, leftRight ? -0.5f : 1.0f, leftRight ? 0.5f : 0.0f, fftMidRaw,
+                                         fftMidPhase))
+          continue;
+      } else if (leftRight) {
+        ConstantQ::compute(*kernels, ring.mid(), ring.side(), end, -0.5f, 0.5f, fftMidRaw, fftMidPhase);
       } else {
-        ConstantQ::compute(bufferSide, bufferMid, 1.0f, 0.0f, fftSideRaw, fftSidePhase);
+        ConstantQ::compute(*kernels, ring.mid(), ring.side(), end, 1.0f, 0.0f, fftMidRaw, fftMidPhase);
       }
+      FFT::Column column = FFT::takeColumn();
+      column.frame = end;
+      column.magnitude = fftMidRaw;
+      column.phase = fftMidPhase;
+      FFT::publish(std::move(column));
+
+      if (end != lastColumn)
+        Accumulator::process(Accumulator::mid, fftMidRaw, columnSeconds(end, lastColumn));
     } else {
-      fftSideRaw.resize(Config::options.fft.size / 2 + 1);
-      fftSidePhase.resize(Config::options.fft.size / 2 + 1);
-      size_t start = (writePos + bufferSize - Config::options.fft.size) % bufferSize;
-
-      // Apply window function and prepare FFT input
-      for (int i = 0; i < Config::options.fft.size; i++) {
-        float win = 0.5f * (1.f - cos(2.f * M_PI * i / (Config::options.fft.size)));
-        size_t pos = (start + i) % bufferSize;
-        if (Config::options.fft.mode == "leftright")
-          FFT::inSide[i] = (bufferSide[pos] + bufferMid[pos]) * 0.5f * win;
-        else
-          FFT::inSide[i] = bufferSide[pos] * win;
+      const size_t size = Config::options.fft.size;
+      const size_t bins = size / 2 + 1;
+      const size_t hop = std::clamp<size_t>(Config::options.fft.hop, 1, size);
+
+      // Wait for a full window, then schedule every hop that completed since the last run, keeping the newest
+      // batch if we fell behind
+      if (end < size)
+        continue;
+      if (nextHop == 0)
+        nextHop = end;
+      if (nextHop > end)
+        continue;
+      size_t hops = (end - nextHop) / hop + 1;
+      if (hops > FFT::maxBatch) {
+        nextHop += (hops - FFT::maxBatch) * hop;
+        hops = FFT::maxBatch;
+      }
+      const uint64_t firstEnd = nextHop;
+      nextHop += hops * hop;
+
+      std::lock_guard<std::mutex> lockFft(FFT::mutexMid);
+
+      // Plans are being swapped for a new size, skip until they match
+      if (FFT::window->coeffs.size() != size)
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+
+      // Apply window function and prepare FFT input for each hop
+      const float gainMid = leftRight ? -0.5f : 1.0f;
+      const float gainSide = leftRight ? 0.5f : 0.0f;
+      for (size_t h = 0; h < hops; h++)
+        FFT::prepareInput(ring.latest(firstEnd + h * hop, size), gainMid, gainSide, FFT::inMid + h * size);
+
+      // The packed engine also produces the side spectrum for the newest hop (FFTAlt stays idle)
+      const bool packed = FFT::packedEngine();
+      const bool withSide = packed && !(Config::options.phosphor.enabled && Config::options.waveform.mode == "mono");
+      std::unique_lock<std::mutex> lockSide(FFT::mutexSide, std::defer_lock);
+      if (withSide) {
+        lockSide.lock();
+        FFT::prepareInput(ring.latest(firstEnd + (hops - 1) * hop, size), leftRight ? 0.5f : 0.0f,
+                          leftRight ? 0.5f : 1.0f, FFT::inMid + hops * size);
       }
 
-      // Execute FFT
-      {
-        std::lock_guard<std::mutex> lockFft(FFT::mutexSide);
-        fftwf_execute(FFT::side);
+      // Drop the batch if the producer overwrote the oldest window while we were reading it
+      if (!ring.valid(ring.latest(firstEnd, size).begin))
+        continue;
+
+      if (packed) {
+        // Two real windows per complex transform: mid hops pairwise, the side window rides along
+        const size_t count = hops + withSide;
+        FFT::pack(count);
+        for (size_t p = 0; p < (count + 1) / 2; p++) {
+          const size_t a = 2 * p;
+          const size_t b = a + 1;
+          fftwf_complex* outB = nullptr;
+          if (b < hops)
+            outB = FFT::outMid + b * bins;
+          else if (b == hops && withSide)
+            outB = FFT::outSide;
+          FFT::unpack(p, a < hops ? FFT::outMid + a * bins : FFT::outSide, outB);
+        }
+      } else {
+        // Execute all hops as one batch
+        FFT::execute(hops);
       }
 
-      // Convert to magnitude spectrum
-      const float scale = 2.f / Config::options.fft.size;
-      for (int i = 0; i < Config::options.fft.size / 2 + 1; i++) {
-        float mag = sqrt(FFT::outSide[i][0] * FFT::outSide[i][0] + FFT::outSide[i][1] * FFT::outSide[i][1]) * scale;
-        if (i != 0 && i != Config::options.fft.size / 2)
-          mag *= 2.f;
-        fftSideRaw[i] = mag;
+      // Convert to magnitude and phase spectra, queueing every hop in time order
+      const bool withPhase = FFT::phaseNeeded();
+      for (size_t h = 0; h < hops; h++) {
+        FFT::Column column = FFT::takeColumn();
+        column.frame = firstEnd + h * hop;
+        column.magnitude.resize(bins);
+        column.phase.resize(withPhase ? bins : 0);
+        FFT::toSpectrum(FFT::outMid + h * bins, size, column.magnitude.data(),
+                        withPhase ? column.phase.data() : nullptr);
+
+        // The newest hop is the live spectrum
+        if (h + 1 == hops) {
+          fftMidRaw = column.magnitude;
+          fftMidPhase = column.phase;
+        }
+        Accumulator::process(Accumulator::mid, column.magnitude, hop / Config::options.audio.sample_rate);
+        FFT::publish(std::move(column));
       }
 
-      // Convert to phase spectrum
-      for (int i = 0; i < Config::options.fft.size / 2 + 1; i++) {
-        fftSidePhase[i] = std::atan2(FFT::outSide[i][1], FFT::outSide[i][0]);
+      if (withSide) {
+        fftSideRaw.resize(bins);
+        fftSidePhase.resize(withPhase ? bins : 0);
+        FFT::toSpectrum(FFT::outSide, size, fftSideRaw.data(), withPhase ? fftSidePhase.data() : nullptr);
+
+        // Only the newest hop has a side spectrum, so it stands in for the whole batch
+        Accumulator::process(Accumulator::side, fftSideRaw, hops * hop / Config::options.audio.sample_rate);
       }
+
+      FFT::recordTiming(std::chrono::steady_clock::now() - start, hops + withSide);
+      FFT::reportTiming();
     }
 
-    // Apply smoothing to alternative channel
+    // Smoothing speeds are per second, this thread runs at the DSP cadence rather than the render cadence
+    auto now = std::chrono::steady_clock::now();
+    const float dt = std::chrono::duration<float>(now - lastRun).count();
+    lastRun = now;
+
+    // Level of the strongest bin gates pitch-dependent displays on silence
+    if (!fftMidRaw.empty())
+      pitchDB = 20.f * log10f(*std::max_element(fftMidRaw.begin(), fftMidRaw.end()) + FLT_EPSILON);
+
+    Pitch::process(end, dt);
+
+    // Apply smoothing if enabled
     if (Config::options.fft.smoothing.enabled) {
-      fftSide.resize(fftSideRaw.size());
-      size_t bins = fftSide.size();
-      size_t i = 0;
-      bool hovering =
-          !Config::options.fft.sphere.enabled && !Config::options.phosphor.enabled && Config::options.fft.cursor;
-      auto window = VisualizerRegistry::find("spectrum_analyzer").lock();
-      hovering = hovering && window->hovering;
-      const float riseSpeed = Config::options.fft.smoothing.rise_speed * WindowManager::dt;
-      const float fallSpeed =
-          (hovering ? Config::options.fft.smoothing.hover_fall_speed : Config::options.fft.smoothing.fall_speed) *
-          WindowManager::dt;
-
-      // SIMD-optimized smoothing
-#ifdef HAVE_AVX2
-      const __m256 riseSpeedVec = _mm256_set1_ps(riseSpeed);
-      const __m256 fallSpeedVec = _mm256_set1_ps(fallSpeed);
-      const __m256 minVVec = _mm256_set1_ps(FLT_EPSILON);
-      const __m256 dbScaleVec = _mm256_set1_ps(20.0f);
-      const __m256 oneVec = _mm256_set1_ps(1.0f);
-      const __m256 negOneVec = _mm256_set1_ps(-1.0f);
-      for (; i + 7 < bins; i += 8) {
-        __m256 cur = _mm256_loadu_ps(&fftSideRaw[i]);
-        __m256 prev = _mm256_loadu_ps(&fftSide[i]);
+      Smoothing::process(midSmoothing, fftMidRaw, fftMid, dt);
+      if (FFT::packedEngine() && !Config::options.fft.cqt.enabled)
+        Smoothing::process(sideSmoothing, fftSideRaw, fftSide, dt);
+    }
+
+    Accumulator::publish(Accumulator::mid);
+    if (FFT::packedEngine() && !Config::options.fft.cqt.enabled)
+      Accumulator::publish(Accumulator::side);
+  }
+
+  return 0;
+}
 
-        __m256 curDB = _mm256_mul_ps(_mm256_log10_ps(_mm256_add_ps(cur, minVVec)), dbScaleVec);
-        __m256 prevDB = _mm256_mul_ps(_mm256_log10_ps(_mm256_add_ps(prev, minVVec)), dbScaleVec);
+int FFTAlt(std::stop_token stoken) {
+  std::stop_callback cb {stoken, [] { fftAltWake.notify(); }};
+  auto lastRun = std::chrono::steady_clock::now();
 
-        __m256 diff = _mm256_sub_ps(curDB, prevDB);
-        __m256 isRise = _mm256_cmp_ps(diff, _mm256_setzero_ps(), _CMP_GT_OS);
+  // End frame of the last column folded into the accumulator
+  uint64_t lastColumn = 0;
 
-        __m256 absDiff = _mm256_andnot_ps(_mm256_set1_ps(-0.f), diff);
-        __m256 change = _mm256_mul_ps(_mm256_min_ps(absDiff, _mm256_blendv_ps(fallSpeedVec, riseSpeedVec, isRise)),
-                                      _mm256_blendv_ps(negOneVec, oneVec, isRise));
+  while (true) {
+    fftAltWake.wait();
+    if (stoken.stop_requested())
+      break;
 
-        __m256 newDB =
-            _mm256_blendv_ps(_mm256_add_ps(prevDB, change), curDB,
-                             _mm256_cmp_ps(absDiff, _mm256_blendv_ps(fallSpeedVec, riseSpeedVec, isRise), _CMP_LE_OS));
+    // Smoothing speeds are per second, this thread runs at the DSP cadence rather than the render cadence
+    auto now = std::chrono::steady_clock::now();
+    const float dt = std::chrono::duration<float>(now - lastRun).count();
+    lastRun = now;
 
-        __m256 newVal = _mm256_sub_ps(_mm256_pow_ps(_mm256_set1_ps(10.f), _mm256_div_ps(newDB, dbScaleVec)), minVVec);
-        _mm256_storeu_ps(&fftSide[i], newVal);
-      }
-#endif
-      // Standard smoothing
-      for (; i < bins; ++i) {
-        float currentDB = 20.f * log10f(fftSideRaw[i] + FLT_EPSILON);
-        float prevDB = 20.f * log10f(fftSide[i] + FLT_EPSILON);
-        float diff = currentDB - prevDB;
-        float speed = diff > 0 ? riseSpeed : fallSpeed;
-        float absDiff = std::abs(diff);
-        float change = std::min(absDiff, speed) * (diff > 0.f ? 1.f : -1.f);
-        float newDB;
-        if (absDiff <= speed)
-          newDB = currentDB;
-        else
-          newDB = prevDB + change;
-        fftSide[i] = powf(10.f, newDB / 20.f) - FLT_EPSILON;
+    if (Config::options.phosphor.enabled && Config::options.waveform.mode == "mono")
+      continue;
+
+    // FFTMain produces both spectra with the packed engine
+    if (FFT::packedEngine() && !Config::options.fft.cqt.enabled)
+      continue;
+
+    // Snapshot the ring head once so both paths see the same frames
+    const uint64_t end = ring.head();
+    const bool leftRight = Config::options.fft.mode == "leftright";
+
+    // Process alternative channel FFT (for stereo visualization)
+    if (Config::options.fft.cqt.enabled) {
+      // Pin one kernel set for the whole frame; rebuilds publish a new one in the background
+      const auto kernels = ConstantQ::current();
+      if (kernels->engine == ConstantQ::Engine::Sparse) {
+        std::lock_guard<std::mutex> lockFft(FFT::mutexSide);
+        if (!ConstantQ::computeSparse(*kernels, end, leftRight ? 0.5f : 0.0f, leftRight ? 0.5f : 1.0f, FFT::side,
+                                      FFT::inSide, FFT::outSide, fftSideRaw, fftSidePhase))
+          continue;
+      } else if (kernels->engine == ConstantQ::Engine::Multirate) {
+        static ConstantQ::Multirate state;
+        ConstantQ::computeMultirate(*kernels, state, end, leftRight ? 0.5f : 0.0f, leftRight ? 0.5f : 1.0f, fftSideRaw,
+                                    fftSidePhase);
+      } else if (kernels->engine == ConstantQ::Engine::Sliding) {
+        static ConstantQ::Sliding state;
+        ConstantQ::computeSliding(*kernels, state, end, leftRight ? 0.5f : 0.0f, leftRight ? 0.5f : 1.0f, fftSideRaw,
+                                  fftSidePhase);
+      } else if (kernels->engine == ConstantQ::Engine::Symmetric) {
+        if (!ConstantQ::computeSymmetric(*kernels, end, leftRight ? 0.5f : 0.0f, leftRight ? 0.5f : 1.0f, fftSideRaw,
+                                         fftSidePhase))
+          continue;
+      } else if (leftRight) {
+        ConstantQ::compute(*kernels, ring.mid(), ring.side(), end, 0.5f, 0.5f, fftSideRaw, fftSidePhase);
+      } else {
+        ConstantQ::compute(*kernels, ring.side(), ring.mid(), end, 1.0f, 0.0f, fftSideRaw, fftSidePhase);
       }
+    } else {
+      // Wait for a full window
+      if (end < static_cast<uint64_t>(Config::options.fft.size))
+        continue;
+      fftSideRaw.resize(Config::options.fft.size / 2 + 1);
+      const bool withPhase = FFT::phaseNeeded();
+      fftSidePhase.resize(withPhase ? Config::options.fft.size / 2 + 1 : 0);
+      const RingBuffer::Span span = ring.latest(end, Config::options.fft.size);
+      std::lock_guard<std::mutex> lockFft(FFT::mutexSide);
+      if (FFT::window->coeffs.size() != span.count)
+        continue;
+
+      auto start = std::chrono::steady_clock::now();
+
+      // Apply window function and prepare FFT input
+      FFT::prepareInput(span, leftRight ? 0.5f : 0.0f, leftRight ? 0.5f : 1.0f, FFT::inSide);
+
+      // Drop the frame if the producer overwrote the window while we were reading it
+      if (!ring.valid(span.begin))
+        continue;
+
+      // Execute FFT
+      fftwf_execute_dft_r2c(FFT::side, FFT::inSide, FFT::outSide);
+
+      // Convert to magnitude and phase spectra
+      FFT::toSpectrum(FFT::outSide, span.count, fftSideRaw.data(), withPhase ? fftSidePhase.data() : nullptr);
+      FFT::recordTiming(std::chrono::steady_clock::now() - start, 1);
     }
+
+    // Apply smoothing to alternative channel
+    if (Config::options.fft.smoothing.enabled)
+      Smoothing::process(sideSmoothing, fftSideRaw, fftSide, dt);
+
+    if (end != lastColumn)
+      Accumulator::process(Accumulator::side, fftSideRaw, columnSeconds(end, lastColumn));
+    Accumulator::publish(Accumulator::side);
+  }
+
+  return 0;
+}
+
+int LUFSWorker(std::stop_token stoken) {
+  std::stop_callback cb {stoken, [] { lufsWake.notify(); }};
+
+#ifdef __linux__
+  // Loudness may trail by a block; leave the cores to the spectrum threads when they compete
+  setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 10);
+#endif
+
+  while (true) {
+    lufsWake.wait();
+    if (stoken.stop_requested())
+      break;
+
+    std::lock_guard<std::mutex> lock(LUFS::mutex);
+    LUFS::addSamples();
+    LUFS::process();
   }
 
   return 0;
@@ -903,10 +2822,11 @@ int mainThread(std::stop_token stoken) {
   // Start FFT processing threads
   std::jthread FFTMainThread(Threads::FFTMain);
   std::jthread FFTAltThread(Threads::FFTAlt);
+  std::jthread LUFSThread(Threads::LUFSWorker);
 
   while (!stoken.stop_requested()) {
-    // Calculate samples to read based on frame time
-    size_t sampleCount = Config::options.audio.sample_rate / Config::options.window.fps_limit;
+    // Wake as soon as the backend has a block of new frames, sized by the latency target
+    size_t sampleCount = AudioEngine::blockFrames();
     readBuf.resize(sampleCount * 2);
 
     // Read audio from engine
@@ -919,47 +2839,17 @@ int mainThread(std::stop_token stoken) {
     }
 
 #if HAVE_PULSEAUDIO
-    float gain = powf(10.0f, Config::options.audio.gain_db / 20.0f);
-    if (AudioEngine::Pulseaudio::running) {
-      size_t i = 0;
-#ifdef HAVE_AVX2
-      // SIMD-optimized audio processing for PulseAudio
-      size_t simd_samples = (sampleCount * 2) & ~7;
-
-      __m256i left_idx = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
-      __m256i right_idx = _mm256_setr_epi32(1, 3, 5, 7, 0, 0, 0, 0);
-
-      __m256 vGain = _mm256_set1_ps(0.5f * gain);
-
-      for (; i < simd_samples; i += 8) {
-        __m256 samples = _mm256_loadu_ps(&readBuf[i]);
-
-        __m256 left = _mm256_permutevar8x32_ps(samples, left_idx);
-        __m256 right = _mm256_permutevar8x32_ps(samples, right_idx);
-
-        __m256 mid = _mm256_mul_ps(_mm256_add_ps(left, right), vGain);
-        __m256 side = _mm256_mul_ps(_mm256_sub_ps(left, right), vGain);
-
-        _mm_storeu_ps(&bufferMid[writePos], _mm256_castps256_ps128(mid));
-        _mm_storeu_ps(&bufferSide[writePos], _mm256_castps256_ps128(side));
-        writePos = (writePos + 4) % bufferSize;
-      }
-#endif
-      for (; i < sampleCount * 2; i += 2) {
-        float left = readBuf[i] * gain;
-        float right = readBuf[i + 1] * gain;
-        bufferMid[writePos] = (left + right) / 2.f;
-        bufferSide[writePos] = (left - right) / 2.f;
-        writePos = (writePos + 1) % bufferSize;
-      }
-    }
+    // PulseAudio reads are blocking, so this thread is the ring producer
+    if (AudioEngine::Pulseaudio::running)
+      pushInterleaved(readBuf.data(), sampleCount, powf(10.0f, Config::options.audio.gain_db / 20.0f));
 #endif
 
     // Signal FFT threads that new data is available
-    fftMainSem.release();
-    fftAltSem.release();
+    fftMainWake.notify();
+    fftAltWake.notify();
 
     // Process bandpass filter if pitch is detected
+    const float pitch = Pitch::current().frequency;
     if (pitch > Config::options.fft.limits.min_freq && pitch < Config::options.fft.limits.max_freq)
       FIR::process(pitch);
 
@@ -967,12 +2857,8 @@ int mainThread(std::stop_token stoken) {
     if (Config::options.oscilloscope.lowpass.enabled)
       Lowpass::process();
 
-    // Add samples to LUFS calculation from processed buffers and process LUFS
-    {
-      std::lock_guard<std::mutex> lock(LUFS::mutex);
-      LUFS::addSamples(sampleCount);
-      LUFS::process();
-    }
+    // Loudness is integrated on its own worker from the ring
+    lufsWake.notify();
 
     // Process peak detection
     Peak::process();
@@ -980,25 +2866,111 @@ int mainThread(std::stop_token stoken) {
     // Process RMS calculation
     RMS::process();
 
-    // Signal main thread that DSP processing is complete
-    mainSem.release();
-
-    // Wait to start next frame
-    static auto lastTime = std::chrono::steady_clock::now();
-    auto now = std::chrono::steady_clock::now();
-    auto targetTime = lastTime + std::chrono::duration<double>(1.0 / Config::options.window.fps_limit);
-    if (now < targetTime)
-      std::this_thread::sleep_until(targetTime);
-    now = std::chrono::steady_clock::now();
-    WindowManager::dt = std::chrono::duration<float>(now - lastTime).count();
-    lastTime = now;
+    // Signal main thread that new DSP results are available, rendering paces itself
+    mainWake.notify();
   }
 
+  // The worker must be done with the meter before it is torn down
+  LUFSThread.request_stop();
+  LUFSThread.join();
   LUFS::reset();
   return 0;
 }
 } // namespace Threads
 
+namespace TruePeak {
+
+void Interpolator::init(size_t oversampling) {
+  *this = {};
+  factor = std::clamp<size_t>(oversampling, 1, maxFactor);
+  if (factor == 1) {
+    // No oversampling: the single branch passes the newest frame through
+    coeffs[phaseTaps - 1][0] = coeffs[phaseTaps - 1][maxFactor] = 1.0f;
+    return;
+  }
+
+  // Windowed sinc at the input Nyquist, sampled at the oversampled rate and split into factor branches
+  const size_t length = factor * phaseTaps;
+  const std::vector<float> window = FIR::kaiser_window(length, kaiserBeta);
+  const double center = (length - 1) / 2.0;
+  double gain[maxFactor] = {};
+  double taps[maxFactor][phaseTaps];
+  for (size_t n = 0; n < length; n++) {
+    const double t = (n - center) / factor;
+    const double h = std::sin(M_PI * t) / (M_PI * t) * window[n];
+    taps[n % factor][n / factor] = h;
+    gain[n % factor] += h;
+  }
+
+  // Unity DC gain per branch; history is stored oldest first, so tap k multiplies row phaseTaps - 1 - k
+  for (size_t p = 0; p < factor; p++) {
+    for (size_t k = 0; k < phaseTaps; k++) {
+      const float c = static_cast<float>(taps[p][k] / gain[p]);
+      coeffs[phaseTaps - 1 - k][p] = c;
+      coeffs[phaseTaps - 1 - k][maxFactor + p] = c;
+    }
+  }
+}
+
+void Interpolator::process(const float* left, const float* right, size_t count, float& peakLeft,
+                           float& peakRight) {
+#ifdef HAVE_AVX2
+  const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  __m256 peak = _mm256_setzero_ps();
+  for (size_t i = 0; i < count; i++) {
+    const __m256 x = _mm256_set_m128(_mm_set1_ps(right[i]), _mm_set1_ps(left[i]));
+    _mm256_store_ps(history[pos], x);
+    _mm256_store_ps(history[pos + phaseTaps], x);
+    pos = pos + 1 == phaseTaps ? 0 : pos + 1;
+
+    // Rows pos .. pos + phaseTaps - 1 are the last phaseTaps frames, oldest first
+    __m256 acc = _mm256_mul_ps(_mm256_load_ps(history[pos]), _mm256_load_ps(coeffs[0]));
+    for (size_t k = 1; k < phaseTaps; k++)
+      acc = _mm256_fmadd_ps(_mm256_load_ps(history[pos + k]), _mm256_load_ps(coeffs[k]), acc);
+    peak = _mm256_max_ps(peak, _mm256_and_ps(acc, absMask));
+  }
+
+  // Fold the branches of each channel
+  __m128 l = _mm256_castps256_ps128(peak);
+  __m128 r = _mm256_extractf128_ps(peak, 1);
+  l = _mm_max_ps(l, _mm_movehl_ps(l, l));
+  r = _mm_max_ps(r, _mm_movehl_ps(r, r));
+  l = _mm_max_ss(l, _mm_shuffle_ps(l, l, 1));
+  r = _mm_max_ss(r, _mm_shuffle_ps(r, r, 1));
+  peakLeft = std::max(peakLeft, _mm_cvtss_f32(l));
+  peakRight = std::max(peakRight, _mm_cvtss_f32(r));
+#else
+  for (size_t i = 0; i < count; i++) {
+    for (size_t p = 0; p < maxFactor; p++) {
+      history[pos][p] = history[pos + phaseTaps][p] = left[i];
+      history[pos][maxFactor + p] = history[pos + phaseTaps][maxFactor + p] = right[i];
+    }
+    pos = pos + 1 == phaseTaps ? 0 : pos + 1;
+
+    for (size_t p = 0; p < factor; p++) {
+      float l = 0.0f;
+      float r = 0.0f;
+      for (size_t k = 0; k < phaseTaps; k++) {
+        l += history[pos + k][p] * coeffs[k][p];
+        r += history[pos + k][maxFactor + p] * coeffs[k][maxFactor + p];
+      }
+      peakLeft = std::max(peakLeft, std::abs(l));
+      peakRight = std::max(peakRight, std::abs(r));
+    }
+  }
+#endif
+}
+
+size_t factorFor(float sampleRate) {
+  if (sampleRate < 96000.0f)
+    return 4;
+  if (sampleRate < 192000.0f)
+    return 2;
+  return 1;
+}
+
+} // namespace TruePeak
+
 namespace LUFS {
 
 std::mutex mutex;
@@ -1009,45 +2981,310 @@ float lufs = -70.0f;
 // libebur128 state
 ebur128_state* state = nullptr;
 
+// Engine and sample rate chosen at the last init()
+Engine engine = Engine::Libebur128;
+float initSampleRate = 0.0f;
+
+// Left/right frames converted from the ring, allocated once for the largest poll: interleaved for
+// libebur128, left and right halves for the native meter
+std::vector<float, AlignedAllocator<float, 32>> frames;
+
+std::atomic<std::shared_ptr<const Measurement>> published {std::make_shared<const Measurement>()};
+
+/**
+ * @brief Map a lufs.engine value to its engine, falling back to libebur128
+ */
+static Engine parseEngine(const std::string& name) {
+  if (name == "native")
+    return Engine::Native;
+  return Engine::Libebur128;
+}
+
+/**
+ * @brief Loudness of a mean square summed over channels (BS.1770)
+ */
+static inline float loudnessOf(double energy) { return static_cast<float>(-0.691 + 10.0 * std::log10(energy)); }
+
+void Histogram::add(double e) {
+  const size_t bin = binOf(loudnessOf(e));
+  count[bin]++;
+  energy[bin] += e;
+  total++;
+  totalEnergy += e;
+}
+
+float Histogram::loudness(size_t bin) const { return loudnessOf(energy[bin] / count[bin]); }
+
+Meter meter;
+
+void Meter::init(float sampleRate) {
+  *this = {};
+
+  // Pre-filter and RLB weighting of BS.1770, derived for any sample rate as libebur128 does
+  double f0 = 1681.974450955533;
+  double q = 0.7071752369554196;
+  double k = std::tan(M_PI * f0 / sampleRate);
+  const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+  const double vb = std::pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  b0[0] = (vh + vb * k / q + k * k) / a0;
+  b1[0] = 2.0 * (k * k - vh) / a0;
+  b2[0] = (vh - vb * k / q + k * k) / a0;
+  a1[0] = 2.0 * (k * k - 1.0) / a0;
+  a2[0] = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = std::tan(M_PI * f0 / sampleRate);
+  a0 = 1.0 + k / q + k * k;
+  b0[1] = 1.0;
+  b1[1] = -2.0;
+  b2[1] = 1.0;
+  a1[1] = 2.0 * (k * k - 1.0) / a0;
+  a2[1] = (1.0 - k / q + k * k) / a0;
+
+  blockLength = std::max<size_t>(1, static_cast<size_t>(std::lround(sampleRate * blockSeconds)));
+  truePeak.init(TruePeak::factorFor(sampleRate));
+}
+
+void Meter::process(const float* left, const float* right, size_t count) {
+  truePeak.process(left, right, count, peak[0], peak[1]);
+
+  size_t i = 0;
+  while (i < count) {
+    const size_t len = std::min(count - i, blockLength - blockFill);
+#ifdef HAVE_AVX2
+    // Both channels side by side in double precision; the 38 Hz high-pass needs it
+    const __m128d sb0 = _mm_set1_pd(b0[0]), sb1 = _mm_set1_pd(b1[0]), sb2 = _mm_set1_pd(b2[0]);
+    const __m128d sa1 = _mm_set1_pd(a1[0]), sa2 = _mm_set1_pd(a2[0]);
+    const __m128d hb0 = _mm_set1_pd(b0[1]), hb1 = _mm_set1_pd(b1[1]), hb2 = _mm_set1_pd(b2[1]);
+    const __m128d ha1 = _mm_set1_pd(a1[1]), ha2 = _mm_set1_pd(a2[1]);
+    __m128d shelf1 = _mm_load_pd(s1[0]), shelf2 = _mm_load_pd(s2[0]);
+    __m128d high1 = _mm_load_pd(s1[1]), high2 = _mm_load_pd(s2[1]);
+    __m128d acc = _mm_load_pd(sum);
+    for (size_t j = i; j < i + len; j++) {
+      const __m128d x = _mm_set_pd(right[j], left[j]);
+      const __m128d y0 = _mm_fmadd_pd(sb0, x, shelf1);
+      shelf1 = _mm_fnmadd_pd(sa1, y0, _mm_fmadd_pd(sb1, x, shelf2));
+      shelf2 = _mm_fnmadd_pd(sa2, y0, _mm_mul_pd(sb2, x));
+      const __m128d y = _mm_fmadd_pd(hb0, y0, high1);
+      high1 = _mm_fnmadd_pd(ha1, y, _mm_fmadd_pd(hb1, y0, high2));
+      high2 = _mm_fnmadd_pd(ha2, y, _mm_mul_pd(hb2, y0));
+      acc = _mm_fmadd_pd(y, y, acc);
+    }
+    _mm_store_pd(s1[0], shelf1);
+    _mm_store_pd(s2[0], shelf2);
+    _mm_store_pd(s1[1], high1);
+    _mm_store_pd(s2[1], high2);
+    _mm_store_pd(sum, acc);
+#else
+    for (size_t ch = 0; ch < 2; ch++) {
+      const float* in = ch == 0 ? left : right;
+      for (size_t j = i; j < i + len; j++) {
+        const double x = in[j];
+        const double y0 = b0[0] * x + s1[0][ch];
+        s1[0][ch] = b1[0] * x - a1[0] * y0 + s2[0][ch];
+        s2[0][ch] = b2[0] * x - a2[0] * y0;
+        const double y = b0[1] * y0 + s1[1][ch];
+        s1[1][ch] = b1[1] * y0 - a1[1] * y + s2[1][ch];
+        s2[1][ch] = b2[1] * y0 - a2[1] * y;
+        sum[ch] += y * y;
+      }
+    }
+#endif
+    i += len;
+    blockFill += len;
+    if (blockFill == blockLength)
+      completeBlock();
+  }
+}
+
+void Meter::completeBlock() {
+  const double energy = (sum[0] + sum[1]) / blockLength;
+  sum[0] = sum[1] = 0.0;
+  blockFill = 0;
+
+  // Silence would otherwise let the recursive state decay into denormals
+  for (auto* s : {&s1[0][0], &s1[0][1], &s1[1][0], &s1[1][1], &s2[0][0], &s2[0][1], &s2[1][0], &s2[1][1]})
+    if (std::abs(*s) < std::numeric_limits<double>::min())
+      *s = 0.0;
+
+  momentarySum += energy - blocks[(cursor + shorttermBlocks - momentaryBlocks) % shorttermBlocks];
+  shorttermSum += energy - blocks[cursor];
+  blocks[cursor] = energy;
+  cursor = (cursor + 1) % shorttermBlocks;
+  completed++;
+
+  if (completed % resumBlocks == 0) {
+    shorttermSum = std::accumulate(blocks.begin(), blocks.end(), 0.0);
+    momentarySum = 0.0;
+    for (size_t k = 1; k <= momentaryBlocks; k++)
+      momentarySum += blocks[(cursor + shorttermBlocks - k) % shorttermBlocks];
+  }
+
+  // Gating blocks overlap by 75% and short-term values are taken every step; both start once full
+  const double momentary = std::max(momentarySum, 0.0) / momentaryBlocks;
+  if (completed >= momentaryBlocks && loudnessOf(momentary) >= histogramMin)
+    gating.add(momentary);
+
+  const double shortterm = std::max(shorttermSum, 0.0) / shorttermBlocks;
+  if (completed >= shorttermBlocks && loudnessOf(shortterm) >= histogramMin)
+    range.add(shortterm);
+}
+
+Measurement Meter::measure() const {
+  Measurement m;
+  m.momentary = loudnessOf(std::max(momentarySum, 0.0) / momentaryBlocks);
+  m.shortterm = loudnessOf(std::max(shorttermSum, 0.0) / shorttermBlocks);
+  m.truePeak[0] = 20.0f * std::log10(peak[0]);
+  m.truePeak[1] = 20.0f * std::log10(peak[1]);
+
+  // Integrated: mean of the gating blocks at most 10 LU below the mean of all blocks above -70 LUFS
+  if (gating.total > 0) {
+    uint64_t n = 0;
+    double e = 0.0;
+    for (size_t bin = Histogram::binOf(loudnessOf(gating.totalEnergy / gating.total) - 10.0f); bin < histogramBins;
+         bin++) {
+      n += gating.count[bin];
+      e += gating.energy[bin];
+    }
+    if (n > 0)
+      m.integrated = loudnessOf(e / n);
+  }
+
+  // Loudness range: spread between the 10th and 95th percentile of short-term values above a -20 LU gate
+  if (range.total > 0) {
+    const size_t first = Histogram::binOf(loudnessOf(range.totalEnergy / range.total) - 20.0f);
+    uint64_t n = 0;
+    for (size_t bin = first; bin < histogramBins; bin++)
+      n += range.count[bin];
+    if (n > 0) {
+      const uint64_t lowRank = static_cast<uint64_t>((n - 1) * 0.10 + 0.5);
+      const uint64_t highRank = static_cast<uint64_t>((n - 1) * 0.95 + 0.5);
+      uint64_t seen = 0;
+      float low = 0.0f;
+      float high = 0.0f;
+      for (size_t bin = first; bin < histogramBins; bin++) {
+        if (range.count[bin] == 0)
+          continue;
+        if (seen <= lowRank && lowRank < seen + range.count[bin])
+          low = range.loudness(bin);
+        if (seen <= highRank && highRank < seen + range.count[bin]) {
+          high = range.loudness(bin);
+          break;
+        }
+        seen += range.count[bin];
+      }
+      m.range = high - low;
+    }
+  }
+
+  return m;
+}
+
 void init() {
   std::lock_guard<std::mutex> lock(mutex);
   if (state) {
     ebur128_destroy(&state);
   }
 
+  frames.resize(bufferSize * 2);
+  engine = parseEngine(Config::options.lufs.engine);
+  initSampleRate = Config::options.audio.sample_rate;
+  published.store(std::make_shared<const Measurement>(), std::memory_order_release);
+
+  if (engine == Engine::Native) {
+    meter.init(Config::options.audio.sample_rate);
+    return;
+  }
+
   state = ebur128_init(2, Config::options.audio.sample_rate, EBUR128_MODE_M | EBUR128_MODE_S | EBUR128_MODE_I);
   if (!state) {
     logWarnAt(std::source_location::current(), "Failed to initialize libebur128");
   }
 }
 
-void addSamples(size_t count) {
-  if (!state)
+void reconfigure() {
+  // Other edits keep the session measurement
+  if (parseEngine(Config::options.lufs.engine) == engine && Config::options.audio.sample_rate == initSampleRate)
     return;
+  init();
+}
 
-  // Convert float samples to double for libebur128
-  std::vector<double> doubleSamples(count * 2);
-
-  // Get samples from the most recent buffer positions
-  size_t startPos = (writePos - count + bufferSize) % bufferSize;
+void addSamples() {
+  static RingBuffer::Reader reader;
+  RingBuffer::Span span = ring.poll(reader, bufferSize);
+  if (span.count == 0 || frames.size() < span.count * 2)
+    return;
 
-  for (size_t i = 0; i < count; i++) {
-    size_t bufferIdx = (startPos + i) % bufferSize;
+  if (engine == Engine::Native) {
+    // Planar left/right, one contiguous ring segment at a time
+    float* left = frames.data();
+    float* right = frames.data() + bufferSize;
+    const bool intact = ring.read(span, [=](const float* mid, const float* side, size_t offset, size_t len) {
+      size_t i = 0;
+#ifdef HAVE_AVX2
+      for (; i + 7 < len; i += 8) {
+        const __m256 m = _mm256_loadu_ps(mid + i);
+        const __m256 s = _mm256_loadu_ps(side + i);
+        _mm256_storeu_ps(left + offset + i, _mm256_add_ps(m, s));
+        _mm256_storeu_ps(right + offset + i, _mm256_sub_ps(m, s));
+      }
+#endif
+      for (; i < len; i++) {
+        left[offset + i] = mid[i] + side[i];
+        right[offset + i] = mid[i] - side[i];
+      }
+    });
+    // Torn frames would be gated in as real loudness, drop them like a dropout
+    if (intact)
+      meter.process(left, right, span.count);
+    return;
+  }
 
-    // Convert mid/side back to left/right channels
-    float mid = bufferMid[bufferIdx];
-    float side = bufferSide[bufferIdx];
-    float left = mid + side;
-    float right = mid - side;
+  if (!state)
+    return;
 
-    doubleSamples[i * 2] = static_cast<double>(left);      // Left channel
-    doubleSamples[i * 2 + 1] = static_cast<double>(right); // Right channel
-  }
+  // Convert mid/side back to interleaved left/right, one contiguous ring segment at a time
+  const bool intact = ring.read(span, [](const float* mid, const float* side, size_t offset, size_t len) {
+    float* out = frames.data() + offset * 2;
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    for (; i + 7 < len; i += 8) {
+      const __m256 m = _mm256_loadu_ps(mid + i);
+      const __m256 s = _mm256_loadu_ps(side + i);
+      const __m256 left = _mm256_add_ps(m, s);
+      const __m256 right = _mm256_sub_ps(m, s);
+      // unpack interleaves within 128-bit lanes; the permutes put frames 0-3 and 4-7 back in order
+      const __m256 lo = _mm256_unpacklo_ps(left, right);
+      const __m256 hi = _mm256_unpackhi_ps(left, right);
+      _mm256_storeu_ps(out + i * 2, _mm256_permute2f128_ps(lo, hi, 0x20));
+      _mm256_storeu_ps(out + i * 2 + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+#endif
+    for (; i < len; i++) {
+      out[i * 2] = mid[i] + side[i];
+      out[i * 2 + 1] = mid[i] - side[i];
+    }
+  });
 
-  ebur128_add_frames_double(state, doubleSamples.data(), count);
+  if (intact)
+    ebur128_add_frames_float(state, frames.data(), span.count);
 }
 
 void process() {
+  if (engine == Engine::Native) {
+    const Measurement m = meter.measure();
+    if (Config::options.lufs.mode == "shortterm")
+      lufs = m.shortterm;
+    else if (Config::options.lufs.mode == "integrated")
+      lufs = m.integrated;
+    else
+      lufs = m.momentary;
+    published.store(std::make_shared<const Measurement>(m), std::memory_order_release);
+    return;
+  }
+
   if (!state)
     return;
 
@@ -1064,80 +3301,282 @@ void process() {
 }
 
 void reset() {
+  std::lock_guard<std::mutex> lock(mutex);
   if (state) {
     ebur128_destroy(&state);
     state = nullptr;
   }
 }
 
+std::shared_ptr<const Measurement> current() { return published.load(std::memory_order_acquire); }
+
 } // namespace LUFS
 
 namespace Peak {
-float left;
-float right;
+
+std::atomic<std::shared_ptr<const Levels>> published {std::make_shared<const Levels>()};
+
+// Left/right copies of the polled frames for the true-peak interpolator, allocated once
+std::vector<float, AlignedAllocator<float, 32>> scratch;
+TruePeak::Interpolator interpolator;
+
+// Ballistics state per channel: displayed level and remaining hold time
+float level[2] = {};
+float held[2] = {};
+uint64_t clips[2] = {};
 
 void process() {
-  size_t numSamples = Config::options.audio.sample_rate / Config::options.window.fps_limit;
-  left = 0.0f;
-  right = 0.0f;
-  for (size_t i = 0; i < numSamples; ++i) {
-    size_t bufferIdx = (writePos + i - numSamples + bufferSize) % bufferSize;
-    float sampleMid = bufferMid[bufferIdx];
-    float sampleSide = bufferSide[bufferIdx];
-    float sampleLeft = sampleMid + sampleSide;
-    float sampleRight = sampleMid - sampleSide;
-    float absLeft = std::abs(sampleLeft);
-    float absRight = std::abs(sampleRight);
-    if (absLeft > left)
-      left = absLeft;
-    if (absRight > right)
-      right = absRight;
+  static RingBuffer::Reader reader;
+  static float lastSampleRate = 0.0f;
+  static bool lastTruePeak = false;
+  const float sampleRate = Config::options.audio.sample_rate;
+  const bool oversample = Config::options.lufs.peak.true_peak;
+  if (lastSampleRate != sampleRate || lastTruePeak != oversample) {
+    lastSampleRate = sampleRate;
+    lastTruePeak = oversample;
+    interpolator.init(TruePeak::factorFor(sampleRate));
+    scratch.resize(oversample ? bufferSize * 2 : 0);
+  }
+
+  // Every frame is measured exactly once, however irregularly this runs
+  const RingBuffer::Span span = ring.poll(reader, bufferSize);
+  if (span.count == 0 || sampleRate <= 0.0f)
+    return;
+
+  float peak[2] = {};
+  uint64_t clipped[2] = {};
+  float* left = oversample ? scratch.data() : nullptr;
+  float* right = oversample ? scratch.data() + bufferSize : nullptr;
+  const bool intact = ring.read(span, [&](const float* mid, const float* side, size_t offset, size_t len) {
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 clip = _mm256_set1_ps(clipLevel);
+    __m256 maxLeft = _mm256_setzero_ps();
+    __m256 maxRight = _mm256_setzero_ps();
+    for (; i + 8 <= len; i += 8) {
+      const __m256 m = _mm256_loadu_ps(mid + i);
+      const __m256 s = _mm256_loadu_ps(side + i);
+      const __m256 l = _mm256_add_ps(m, s);
+      const __m256 r = _mm256_sub_ps(m, s);
+      if (oversample) {
+        _mm256_storeu_ps(left + offset + i, l);
+        _mm256_storeu_ps(right + offset + i, r);
+      }
+      const __m256 absLeft = _mm256_and_ps(l, absMask);
+      const __m256 absRight = _mm256_and_ps(r, absMask);
+      maxLeft = _mm256_max_ps(maxLeft, absLeft);
+      maxRight = _mm256_max_ps(maxRight, absRight);
+      clipped[0] += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(absLeft, clip, _CMP_GE_OQ))));
+      clipped[1] += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(absRight, clip, _CMP_GE_OQ))));
+    }
+    peak[0] = std::max(peak[0], avx2_reduce_max_ps(maxLeft));
+    peak[1] = std::max(peak[1], avx2_reduce_max_ps(maxRight));
+#endif
+    for (; i < len; i++) {
+      const float l = mid[i] + side[i];
+      const float r = mid[i] - side[i];
+      if (oversample) {
+        left[offset + i] = l;
+        right[offset + i] = r;
+      }
+      peak[0] = std::max(peak[0], std::abs(l));
+      peak[1] = std::max(peak[1], std::abs(r));
+      clipped[0] += std::abs(l) >= clipLevel;
+      clipped[1] += std::abs(r) >= clipLevel;
+    }
+  });
+
+  // Overwritten frames could show a peak or a clip that never played, leave the levels as they are
+  if (!intact)
+    return;
+  clips[0] += clipped[0];
+  clips[1] += clipped[1];
+
+  if (oversample)
+    interpolator.process(left, right, span.count, peak[0], peak[1]);
+
+  // Hold each new maximum for at least a frame so peaks between renders still show, then decay
+  const float dt = span.count / sampleRate;
+  const float holdTime = std::max(Config::options.lufs.peak.hold_time, 1.0f / Config::options.window.fps_limit);
+  const float fall = std::pow(10.0f, -Config::options.lufs.peak.decay * dt / 20.0f);
+  for (size_t ch = 0; ch < 2; ch++) {
+    if (peak[ch] >= level[ch]) {
+      level[ch] = peak[ch];
+      held[ch] = holdTime;
+    } else if (held[ch] > 0.0f) {
+      held[ch] -= dt;
+    } else if (Config::options.lufs.peak.decay > 0.0f) {
+      level[ch] = std::max(peak[ch], level[ch] * fall);
+    } else {
+      level[ch] = peak[ch];
+    }
   }
+
+  published.store(std::make_shared<const Levels>(Levels {level[0], level[1], clips[0], clips[1]}),
+                  std::memory_order_release);
 }
 
+std::shared_ptr<const Levels> current() { return published.load(std::memory_order_acquire); }
+
 } // namespace Peak
 
 namespace RMS {
-float rms;
+
+std::atomic<std::shared_ptr<const Levels>> published {std::make_shared<const Levels>()};
+
+// Running sums of squared mid, left and right samples over the window ending at end
+double sums[3] = {};
+size_t window = 0;
+uint64_t end = 0;
+uint64_t sinceResum = 0;
+bool stale = true;
+
+// VU needle position and velocity of mid, left and right
+double position[3] = {};
+double velocity[3] = {};
+
+/**
+ * @brief Sums of squared mid, left and right samples over a span of the ring
+ * @return true if the span was not overwritten while reading
+ */
+static bool sumSquares(RingBuffer::Span span, double (&out)[3]) {
+  out[0] = out[1] = out[2] = 0.0;
+  return ring.read(span, [&out](const float* mid, const float* side, size_t, size_t len) {
+    size_t i = 0;
+#ifdef HAVE_AVX2
+    __m256d accMid = _mm256_setzero_pd();
+    __m256d accLeft = _mm256_setzero_pd();
+    __m256d accRight = _mm256_setzero_pd();
+    for (; i + 4 <= len; i += 4) {
+      const __m256d m = _mm256_cvtps_pd(_mm_loadu_ps(mid + i));
+      const __m256d s = _mm256_cvtps_pd(_mm_loadu_ps(side + i));
+      const __m256d l = _mm256_add_pd(m, s);
+      const __m256d r = _mm256_sub_pd(m, s);
+      accMid = _mm256_fmadd_pd(m, m, accMid);
+      accLeft = _mm256_fmadd_pd(l, l, accLeft);
+      accRight = _mm256_fmadd_pd(r, r, accRight);
+    }
+    alignas(32) double lanes[3][4];
+    _mm256_store_pd(lanes[0], accMid);
+    _mm256_store_pd(lanes[1], accLeft);
+    _mm256_store_pd(lanes[2], accRight);
+    for (size_t ch = 0; ch < 3; ch++)
+      out[ch] += (lanes[ch][0] + lanes[ch][1]) + (lanes[ch][2] + lanes[ch][3]);
+#endif
+    for (; i < len; i++) {
+      const double m = mid[i];
+      const double s = side[i];
+      out[0] += m * m;
+      out[1] += (m + s) * (m + s);
+      out[2] += (m - s) * (m - s);
+    }
+  });
+}
+
+/**
+ * @brief Advance the VU needles over a span of the ring
+ * @return true if the span was intact; the needles stay put otherwise
+ */
+static bool ballistics(RingBuffer::Span span, float sampleRate) {
+  // Full-wave rectified input, scaled so a steady sine settles at its RMS
+  constexpr double sineScale = M_PI / (2.0 * M_SQRT2);
+  const double dt = 1.0 / sampleRate;
+  const double spring = vuOmega * vuOmega * dt;
+  const double damping = 2.0 * vuDamping * vuOmega * dt;
+
+  // Integrate into copies so a torn span leaves the needles untouched
+  double pos[3] = {position[0], position[1], position[2]};
+  double vel[3] = {velocity[0], velocity[1], velocity[2]};
+  const bool intact = ring.read(span, [&](const float* mid, const float* side, size_t, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      const double in[3] = {std::abs(mid[i]) * sineScale, std::abs(mid[i] + side[i]) * sineScale,
+                            std::abs(mid[i] - side[i]) * sineScale};
+      for (size_t ch = 0; ch < 3; ch++) {
+        vel[ch] += spring * (in[ch] - pos[ch]) - damping * vel[ch];
+        pos[ch] += vel[ch] * dt;
+      }
+    }
+  });
+  if (!intact)
+    return false;
+
+  std::copy_n(pos, 3, position);
+  std::copy_n(vel, 3, velocity);
+  return true;
+}
 
 void process() {
+  static RingBuffer::Reader reader;
   const float sampleRate = Config::options.audio.sample_rate;
-  const float windowMs = Config::options.vu.window;
+  const RingBuffer::Span span = ring.poll(reader, bufferSize);
+  if (span.count == 0 || sampleRate <= 0.0f)
+    return;
+
+  Levels levels;
+  if (Config::options.vu.ballistics == "vu") {
+    // The window sums were not kept up to date meanwhile
+    stale = true;
+    if (!ballistics(span, sampleRate))
+      return;
+    const double left = std::max(position[1], 0.0);
+    const double right = std::max(position[2], 0.0);
+    levels.mid = static_cast<float>(std::max(position[0], 0.0));
+    levels.left = static_cast<float>(left);
+    levels.right = static_cast<float>(right);
+    levels.stereo = static_cast<float>(std::sqrt((left * left + right * right) / 2.0));
+    published.store(std::make_shared<const Levels>(levels), std::memory_order_release);
+    return;
+  }
 
+  const float windowMs = Config::options.vu.window;
   size_t samples = 0;
-  if (sampleRate > 0.0f && windowMs > 0.0f) {
+  if (windowMs > 0.0f) {
     const double raw = static_cast<double>(sampleRate) * static_cast<double>(windowMs) / 1000.0;
-    if (raw > 0.0) {
-      const double clamped = std::min(raw, static_cast<double>(bufferSize));
-      samples = static_cast<size_t>(clamped);
-    }
+    samples = static_cast<size_t>(std::min(raw, static_cast<double>(bufferSize)));
   }
 
   if (samples == 0) {
-    rms = 0.0f;
+    published.store(std::make_shared<const Levels>(), std::memory_order_release);
     return;
   }
 
-  const size_t start = (writePos + bufferSize - samples) % bufferSize;
-
-  double acc = 0.0;
-  for (size_t i = 0; i < samples; ++i) {
-    const size_t bufferIdx = (start + i);
-    const size_t wrappedIdx = bufferIdx % bufferSize;
-    const float sample = bufferMid[wrappedIdx];
-    acc += static_cast<double>(sample) * static_cast<double>(sample);
+  if (stale || samples != window || span.begin != end || span.count >= samples || sinceResum >= resumFrames) {
+    // Start over from an exact sum of the window
+    stale = !sumSquares(ring.latest(span.end(), samples), sums);
+    sinceResum = 0;
+  } else {
+    // Add the new frames and drop the ones that left the window
+    double added[3];
+    double expired[3];
+    const bool validAdded = sumSquares(span, added);
+    const bool validExpired = sumSquares({span.begin - samples, span.count}, expired);
+    for (size_t ch = 0; ch < 3; ch++)
+      sums[ch] += added[ch] - expired[ch];
+    stale = !validAdded || !validExpired;
+    sinceResum += span.count;
   }
-
-  const double mean = acc / static_cast<double>(samples);
-  rms = static_cast<float>(std::sqrt(std::max(mean, 0.0)));
+  window = samples;
+  end = span.end();
+
+  const double n = static_cast<double>(samples);
+  levels.mid = static_cast<float>(std::sqrt(std::max(sums[0], 0.0) / n));
+  levels.left = static_cast<float>(std::sqrt(std::max(sums[1], 0.0) / n));
+  levels.right = static_cast<float>(std::sqrt(std::max(sums[2], 0.0) / n));
+  levels.stereo = static_cast<float>(std::sqrt(std::max(sums[1] + sums[2], 0.0) / (2.0 * n)));
+  published.store(std::make_shared<const Levels>(levels), std::memory_order_release);
 }
 
+std::shared_ptr<const Levels> current() { return published.load(std::memory_order_acquire); }
+
 } // namespace RMS
 
 // Template instantiations
 template void
-ConstantQ::compute<AlignedAllocator<float, 32>>(const std::vector<float, AlignedAllocator<float, 32>>& inA,
-                                                const std::vector<float, AlignedAllocator<float, 32>>& inB, float gainA,
-                                                float gainB, std::vector<float>& out, std::vector<float>& phase);
+ConstantQ::compute<AlignedAllocator<float, 32>>(const ConstantQ::Kernels& kernels,
+                                                const std::vector<float, AlignedAllocator<float, 32>>& inA,
+                                                const std::vector<float, AlignedAllocator<float, 32>>& inB,
+                                                uint64_t end, float gainA, float gainB, std::vector<float>& out,
+                                                std::vector<float>& phase);
 
 } // namespace DSP
\ No newline at end of file
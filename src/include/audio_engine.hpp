@@ -19,6 +19,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "ring_buffer.hpp"
 
 namespace AudioEngine {
 
@@ -34,6 +35,12 @@ enum class Type { PULSEAUDIO, PIPEWIRE, WASAPI, AUTO };
  */
 Type toType(std::string str);
 
+/**
+ * @brief Capture block size derived from the configured latency target
+ * @return Number of frames the backend should deliver per wakeup
+ */
+size_t blockFrames();
+
 /**
  * @brief PulseAudio backend implementation
  */
@@ -127,6 +134,9 @@ extern struct spa_hook registryListener;
 extern bool initialized;
 extern bool running;
 
+// Interleaved frames copied by the realtime callback, drained by read()
+extern DSP::StagingRing staging;
+
 /**
  * @brief Audio device information
  */
@@ -29,10 +29,12 @@
 #include <any>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cctype>
 #include <chrono>
 #include <cmath>
 #include <complex>
+#include <condition_variable>
 #include <cstdlib>
 #include <deque>
 #include <ebur128.h>
@@ -43,6 +45,8 @@
 #include <ft2build.h>
 #include <functional>
 #include <iostream>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <numeric>
 #include <optional>
@@ -192,11 +196,26 @@ inline float avx2_reduce_add_ps(__m256 v) {
   vLow = _mm_hadd_ps(vLow, vLow);
   return _mm_cvtss_f32(vLow);
 }
+
+/**
+ * @brief Reduces 8 float values to their maximum using AVX2
+ * @param v Vector of 8 float values
+ * @return Largest element of the vector
+ */
+inline float avx2_reduce_max_ps(__m256 v) {
+  __m128 vLow = _mm256_castps256_ps128(v);
+  __m128 vHigh = _mm256_extractf128_ps(v, 1);
+  vLow = _mm_max_ps(vLow, vHigh);
+  vLow = _mm_max_ps(vLow, _mm_movehl_ps(vLow, vLow));
+  vLow = _mm_max_ss(vLow, _mm_shuffle_ps(vLow, vLow, 1));
+  return _mm_cvtss_f32(vLow);
+}
 #endif
 
 #ifdef __linux__
 #include <poll.h>
 #include <sys/inotify.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #endif
 
@@ -243,8 +262,53 @@ typedef ptrdiff_t ssize_t;
 #define FLT_EPSILON 1e-6f
 #endif
 
+/**
+ * @brief Wake-up signal that merges repeated notifications.
+ *
+ * Producers may notify far more often than the consumer waits; all notify() calls between two waits
+ * count as one. The semaphore is only released on the transition to pending, so its count never
+ * exceeds 1. notify() takes no lock and is safe from realtime callbacks.
+ */
+class Wakeup {
+public:
+  void notify() {
+    if (!pending.exchange(true, std::memory_order_acq_rel))
+      sem.release();
+  }
+
+  void wait() {
+    sem.acquire();
+    pending.exchange(false, std::memory_order_acq_rel);
+  }
+
+  /**
+   * @return true if woken, false on timeout
+   */
+  template <typename Rep, typename Period> bool waitFor(const std::chrono::duration<Rep, Period>& timeout) {
+    if (!sem.try_acquire_for(timeout))
+      return false;
+    pending.exchange(false, std::memory_order_acq_rel);
+    return true;
+  }
+
+  /**
+   * @return true if woken, false once the deadline passed
+   */
+  template <typename Clock, typename Duration>
+  bool waitUntil(const std::chrono::time_point<Clock, Duration>& deadline) {
+    if (!sem.try_acquire_until(deadline))
+      return false;
+    pending.exchange(false, std::memory_order_acq_rel);
+    return true;
+  }
+
+private:
+  std::binary_semaphore sem {0};
+  std::atomic<bool> pending {false};
+};
+
 // Thread synchronization variables for DSP data processing
-extern std::binary_semaphore mainSem;
+extern Wakeup mainWake;
 
 /**
  * @brief Expands a path starting with '~' to the user's home directory
@@ -226,6 +226,10 @@ inline constexpr std::array fftSizeDetents = {
   128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768
 };
 
+inline constexpr std::array fftHopDetents = {
+  64, 128, 256, 512, 1024, 2048, 4096, 8192
+};
+
 inline constexpr std::array rotationChoices = {
   Choice<Config::Rotation>{Config::Rotation::ROTATION_0,   "0deg"},
   Choice<Config::Rotation>{Config::Rotation::ROTATION_90,  "90deg"},
@@ -275,6 +279,43 @@ inline constexpr std::array fftStereoChoices = {
   Choice<std::string_view>{"leftright", "Left/Right"},
 };
 
+inline constexpr std::array fftWindowChoices = {
+  Choice<std::string_view>{"hann",            "Hann"},
+  Choice<std::string_view>{"blackman_harris", "Blackman-Harris"},
+  Choice<std::string_view>{"kaiser",          "Kaiser"},
+  Choice<std::string_view>{"flattop",         "Flat-top"},
+};
+
+inline constexpr std::array fftPlannerChoices = {
+  Choice<std::string_view>{"estimate", "Estimate"},
+  Choice<std::string_view>{"measure",  "Measure"},
+  Choice<std::string_view>{"patient",  "Patient"},
+};
+
+inline constexpr std::array fftEngineChoices = {
+  Choice<std::string_view>{"split",  "Split (two threads)"},
+  Choice<std::string_view>{"packed", "Packed (one thread)"},
+};
+
+inline constexpr std::array cqtEngineChoices = {
+  Choice<std::string_view>{"direct",    "Direct"},
+  Choice<std::string_view>{"sparse",    "Sparse (FFT-based)"},
+  Choice<std::string_view>{"multirate", "Multirate (octave-decimated)"},
+  Choice<std::string_view>{"sliding",   "Sliding (recursive DFT)"},
+  Choice<std::string_view>{"symmetric", "Symmetric (folded kernels)"},
+};
+
+inline constexpr std::array cqtPrecisionChoices = {
+  Choice<std::string_view>{"float", "Float (32-bit)"},
+  Choice<std::string_view>{"half",  "Half (16-bit)"},
+};
+
+inline constexpr std::array fftAverageChoices = {
+  Choice<std::string_view>{"none",        "None"},
+  Choice<std::string_view>{"exponential", "Exponential"},
+  Choice<std::string_view>{"linear",      "Linear (last N frames)"},
+};
+
 inline constexpr std::array frequencyScaleOptions = {
   Choice<std::string_view>{"log",    "Logarithmic"},
   Choice<std::string_view>{"linear", "Linear"},
@@ -293,6 +334,11 @@ inline constexpr std::array audioEngineChoices = {
   Choice<std::string_view>{"wasapi",     "WASAPI"},
 };
 
+inline constexpr std::array lufsEngineChoices = {
+  Choice<std::string_view>{"libebur128", "libebur128"},
+  Choice<std::string_view>{"native",     "Native (BS.1770)"},
+};
+
 inline constexpr std::array lufsModeChoices = {
   Choice<std::string_view>{"shortterm",  "Short-term"},
   Choice<std::string_view>{"momentary",  "Momentary"},
@@ -310,6 +356,11 @@ inline constexpr std::array lufsLabelChoices = {
   Choice<std::string_view>{"compact", "Compact"},
 };
 
+inline constexpr std::array vuBallisticsChoices = {
+  Choice<std::string_view>{"window", "RMS Window"},
+  Choice<std::string_view>{"vu",     "VU (IEC 60268-17)"},
+};
+
 inline constexpr std::array vuStyleChoices = {
   Choice<std::string_view>{"analog",  "Analog"},
   Choice<std::string_view>{"digital", "Digital"},
@@ -357,6 +408,10 @@ inline constexpr std::array boolFields = {
     bool, fft.smoothing.enabled,
     "Enable Peak Smoothing",
     "Smooth bar motion to reduce jitter in FFT amplitudes."),
+  PV_SCHEMA_FIELD(
+    bool, fft.accumulator.peak_hold,
+    "Peak Hold Curve",
+    "Draw the maximum of each bin over time, decaying at the peak decay rate."),
   PV_SCHEMA_FIELD(
     bool, fft.cqt.enabled,
     "Enable Constant-Q Transform",
@@ -403,6 +458,11 @@ inline constexpr std::array boolFields = {
     "Rotate beam hue based on drawing direction for a chroma trail effect.\n"
     "This can be GPU-intensive."),
 
+  PV_SCHEMA_FIELD(
+    bool, lufs.peak.true_peak,
+    "True Peak",
+    "Estimate inter-sample peaks by 4x oversampling (2x from 96 kHz) instead of reading sample values."),
+
   PV_SCHEMA_FIELD(
     bool, vu.momentum.enabled,
     "Enable Needle Momentum",
@@ -463,11 +523,26 @@ inline constexpr std::array intFields = {
     "FFT Size",
     "Analysis window size. Larger values improve frequency detail but increase latency.",
     FieldUi<int>::detentSlider(std::span<const int>(fftSizeDetents))),
+  PV_SCHEMA_FIELD(
+    int, fft.hop,
+    "FFT Hop",
+    "Samples between consecutive analysis frames. Smaller values give the spectrogram finer time resolution.",
+    FieldUi<int>::detentSlider(std::span<const int>(fftHopDetents))),
   PV_SCHEMA_FIELD(
     int, fft.cqt.bins_per_octave,
     "CQT Bins per Octave",
     "Number of CQT bins per octave. Higher values improve note resolution but cost more CPU.",
     FieldUi<int>::slider(16, 128, 0)),
+  PV_SCHEMA_FIELD(
+    int, fft.accumulator.average_frames,
+    "Average Frames",
+    "Number of analysed FFT frames (one per fft.hop) in the linear average.",
+    FieldUi<int>::slider(2, 1000, 0)),
+  PV_SCHEMA_FIELD(
+    int, fft.cqt.threads,
+    "CQT Threads",
+    "Threads sharing each channel's CQT bins, including the FFT thread. 0 picks automatically.",
+    FieldUi<int>::slider(0, 32, 0)),
 
   PV_SCHEMA_FIELD(
     int, window.default_width,
@@ -482,7 +557,7 @@ inline constexpr std::array intFields = {
   PV_SCHEMA_FIELD(
     int, window.fps_limit,
     "Frame Rate Limit",
-    "Target frame rate for rendering. Actual cadence may vary with audio backend buffer sizing.",
+    "Target frame rate for rendering. Rendering never runs faster than new audio arrives (see Latency Target).",
     FieldUi<int>::slider(1, 1000, 1)),
 };
 
@@ -583,6 +658,21 @@ inline constexpr std::array floatFields = {
     "Hover Fall Speed",
     "How quickly FFT peaks fall when hovered.",
     FieldUi<float>::slider(10.f, 1000.f, 1)),
+  PV_SCHEMA_FIELD(
+    float, fft.accumulator.peak_decay,
+    "Peak Hold Decay (dB/s)",
+    "How quickly the peak hold curve falls. 0 holds peaks indefinitely.",
+    FieldUi<float>::slider(0.f, 60.f, 1)),
+  PV_SCHEMA_FIELD(
+    float, fft.accumulator.average_time,
+    "Average Time Constant (s)",
+    "Time constant of the exponential average.",
+    FieldUi<float>::slider(0.1f, 60.f, 1)),
+  PV_SCHEMA_FIELD(
+    float, fft.smoothing.hold_time,
+    "Peak Hold Time (s)",
+    "How long FFT peaks stay in place before falling. 0 disables peak hold.",
+    FieldUi<float>::slider(0.f, 5.f, 2)),
   PV_SCHEMA_FIELD(
     float, fft.smoothing.rise_speed,
     "Rise Speed",
@@ -666,6 +756,11 @@ inline constexpr std::array floatFields = {
     "Input Gain (dB)",
     "Pre-visualization gain adjustment. Increase for quiet sources, reduce to avoid clipping.",
     FieldUi<float>::slider(-60.f, 12.f, 1)),
+  PV_SCHEMA_FIELD(
+    float, audio.latency,
+    "Latency Target (ms)",
+    "Capture block duration. The DSP thread wakes for every block, independently of the frame rate limit.",
+    FieldUi<float>::slider(1.f, 100.f, 1)),
 
   PV_SCHEMA_FIELD(
     float, phosphor.beam.energy,
@@ -713,6 +808,17 @@ inline constexpr std::array floatFields = {
     "Intensity of simulated screen frame reflections.",
     FieldUi<float>::slider(0.f, 1.f, 3, true)),
 
+  PV_SCHEMA_FIELD(
+    float, lufs.peak.hold_time,
+    "Peak Hold Time (s)",
+    "How long a peak stays on the meter before it falls. Never shorter than one frame.",
+    FieldUi<float>::slider(0.f, 5.f, 2)),
+  PV_SCHEMA_FIELD(
+    float, lufs.peak.decay,
+    "Peak Decay (dB/s)",
+    "How quickly a held peak falls. 0 drops straight to the current level.",
+    FieldUi<float>::slider(0.f, 60.f, 1)),
+
   PV_SCHEMA_FIELD(
     float, vu.window,
     "Integration Window (ms)",
@@ -771,6 +877,47 @@ inline constexpr std::array stringFields = {
     "Channel Mode",
     "Analyze channels as Mid/Side or Left/Right.",
     FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(fftStereoChoices))),
+  PV_SCHEMA_FIELD(
+    std::string, fft.window,
+    "FFT Window",
+    "Analysis window shape.\n"
+    "Hann: balanced default.\n"
+    "Blackman-Harris/Kaiser: lower leakage, wider peaks.\n"
+    "Flat-top: accurate peak amplitudes, widest peaks.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(fftWindowChoices))),
+  PV_SCHEMA_FIELD(
+    std::string, fft.planner,
+    "FFT Planner",
+    "How hard FFTW searches for the fastest transform.\n"
+    "Measure/Patient plan in the background and are remembered across restarts.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(fftPlannerChoices))),
+  PV_SCHEMA_FIELD(
+    std::string, fft.engine,
+    "FFT Engine",
+    "Split: each channel has its own real FFT on its own thread.\n"
+    "Packed: both channels share one complex FFT on a single thread, freeing a core.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(fftEngineChoices))),
+  PV_SCHEMA_FIELD(
+    std::string, fft.cqt.engine,
+    "CQT Engine",
+    "Direct: convolve each bin's kernel with the signal.\n"
+    "Sparse: multiply precomputed spectral kernels with one shared FFT, much cheaper at high bin counts.\n"
+    "Multirate: run each octave on a signal decimated by 2 per octave, keeping low-bin kernels short.\n"
+    "Sliding: update a recursive DFT per bin with only the new samples, for high refresh rates.\n"
+    "Symmetric: like Direct, folding the input around each kernel's center for half the multiplies.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(cqtEngineChoices))),
+  PV_SCHEMA_FIELD(
+    std::string, fft.cqt.precision,
+    "CQT Kernel Precision",
+    "Storage of the direct and multirate kernels.\n"
+    "Half: 16-bit floats, halving the memory streamed per frame at about -66 dB of kernel error.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(cqtPrecisionChoices))),
+  PV_SCHEMA_FIELD(
+    std::string, fft.accumulator.average,
+    "Average Curve",
+    "Draw a long-term power average of the spectrum.\n"
+    "Exponential: weighted by the average time constant. Linear: equal weight over the last N frames.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(fftAverageChoices))),
   PV_SCHEMA_FIELD(
     std::string, fft.frequency_scale,
     "Frequency Scale",
@@ -810,6 +957,13 @@ inline constexpr std::array stringFields = {
     "Color/theme preset file used for rendering.",
     FieldUi<std::string>::enumTick(noStringChoices)),
 
+  PV_SCHEMA_FIELD(
+    std::string, lufs.engine,
+    "Loudness Engine",
+    "libebur128: reference library, polled once per frame.\n"
+    "Native: in-tree K-weighted meter with O(1) window updates, histogram gating,\n"
+    "loudness range and 4x oversampled true peak.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(lufsEngineChoices))),
   PV_SCHEMA_FIELD(
     std::string, lufs.mode,
     "Measurement Mode",
@@ -830,6 +984,12 @@ inline constexpr std::array stringFields = {
     "Compact: compact label above bar.",
     FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(lufsLabelChoices))),
 
+  PV_SCHEMA_FIELD(
+    std::string, vu.ballistics,
+    "Ballistics",
+    "RMS Window: true RMS over the integration window.\n"
+    "VU: average-responding needle reaching 99% in 300 ms with slight overshoot, calibrated to sine RMS.",
+    FieldUi<std::string>::enumDrop(std::span<const Choice<std::string_view>>(vuBallisticsChoices))),
   PV_SCHEMA_FIELD(
     std::string, vu.style,
     "Meter Style",
@@ -19,12 +19,13 @@
 
 #pragma once
 #include "common.hpp"
+#include "ring_buffer.hpp"
+#include "work_pool.hpp"
 #include "types.hpp"
 
 namespace DSP {
 
-// Pitch detection
-extern float pitch;
+// Level of the strongest spectral peak in dB, used as a silence gate
 extern float pitchDB;
 
 /**
@@ -35,44 +36,85 @@ extern float pitchDB;
  */
 std::tuple<std::string, int, int> toNote(float freq, std::string* noteNames);
 
+/**
+ * @brief Convert interleaved stereo frames to mid/side and publish them to the sample ring.
+ * @param samples Interleaved left/right samples
+ * @param frames Number of stereo frames
+ * @param gain Linear gain applied before conversion
+ * @note Must only be called from the audio producer.
+ */
+void pushInterleaved(const float* samples, size_t frames, float gain);
+
 /**
  * @brief Linear phase FIR bandpass filter implementation
  */
 namespace FIR {
 
+// Designs are cached per centre frequency quantized to this many cents
+constexpr float designCents = 5.0f;
+// Upper bound on cached designs before the cache is flushed
+constexpr size_t maxDesigns = 512;
+// Samples over which the output fades from the old to the new coefficients
+constexpr size_t crossfadeSamples = 512;
+// Overlap-save transform size; each transform yields blockSize - taps + 1 output samples
+constexpr size_t blockSize = 2048;
+// Longest filter the block engine accepts (design() clamps the order to 512)
+constexpr size_t maxTaps = 1024;
+
 /**
- * @brief FIR filter state and processing helpers.
+ * @brief Block FIR filter using overlap-save FFT convolution over the sample ring.
+ *
+ * Output sample n is sum(coeffs[k] * x[n - k]), so a symmetric design has a group delay of order / 2.
  */
 struct Filter {
   std::vector<float> coeffs;
-  std::vector<float> delay;
-  size_t idx;
-  size_t order;
+  size_t order = 0;
+
+  // Spectra of the zero-padded coefficients (blockSize / 2 + 1 bins), and of the set being faded out
+  std::vector<std::complex<float>> response;
+  std::vector<std::complex<float>> previous;
+  // Remaining fade length in samples
+  size_t fade = 0;
 
   /**
-   * @brief Process one sample through the FIR filter.
-   * @param x Input sample
-   * @return Filtered output sample
+   * @brief Filter frames of the mid signal in the sample ring.
+   * @param span Frames to filter; the taps - 1 frames before it are read as history
+   * @param out Destination for span.count filtered samples, zero where the input was overwritten while reading
    */
-  float process(float x);
+  void process(RingBuffer::Span span, float* out);
 
   /**
    * @brief Set filter coefficients and reset internal state as needed.
-   * @param coeffs FIR coefficient array
+   *
+   * Coefficients of the same length are crossfaded in over crossfadeSamples; a length change
+   * (which also changes the group delay) switches immediately.
+   * @param coeffs FIR coefficient array, at most maxTaps long
    */
   void set_coefficients(const std::vector<float>& coeffs);
 };
 
 extern Filter bandpass_filter;
 
+/**
+ * @brief Allocate the block buffers and plan the overlap-save transforms
+ */
+void init();
+
+/**
+ * @brief Release the overlap-save transforms
+ */
+void cleanup();
+
 /**
  * @brief Design/update the band-pass FIR filter for a center frequency.
+ *
+ * Designs are cached by quantized center frequency and rebuilt only when the band-pass settings change.
  * @param center Center frequency in Hz
  */
 void design(float center);
 
 /**
- * @brief Process samples with the band-pass FIR filter.
+ * @brief Filter the frames published since the last call into DSP::bandpassed.
  * @param center Center frequency in Hz
  */
 void process(float center);
@@ -84,6 +126,9 @@ void process(float center);
  */
 namespace Lowpass {
 
+// Biquad sections the cascade can hold, one per SIMD lane (order 16)
+constexpr size_t maxSections = 8;
+
 /**
  * @brief Initialize lowpass filter
  */
@@ -95,7 +140,8 @@ void init();
 void reconfigure();
 
 /**
- * @brief Process audio through lowpass filter
+ * @brief Filter the frames published since the previous call into DSP::lowpassed
+ * @note A span the producer lapped restarts the cascade from rest.
  */
 void process();
 
@@ -105,54 +151,346 @@ void process();
  * @brief Constant Q Transform implementation
  */
 namespace ConstantQ {
-extern float Q;
-extern size_t bins;
-extern std::vector<float> frequencies;
-extern std::vector<size_t> lengths;
-extern std::vector<std::vector<float, AlignedAllocator<float, 32>>> reals;
-extern std::vector<std::vector<float, AlignedAllocator<float, 32>>> imags;
+
+// Spectral kernel entries below this fraction of the kernel's peak are dropped
+constexpr float sparseThreshold = 0.005f;
+
+// Half-band decimation filter of the multirate engine
+constexpr int halfbandTaps = 47;
+constexpr float halfbandBeta = 7.0f;
+// Bins go to the deepest level where they stay below this fraction of the level's sample rate
+constexpr float multiratePassband = 0.35f;
+// Levels whose longest kernel would be shorter than this are not used
+constexpr size_t minLevelLength = 64;
+
+// Sliding bins are re-seeded from a direct sum after this many recursive updates to bound rounding drift
+constexpr uint64_t slidingResync = uint64_t(1) << 20;
 
 /**
- * @brief Find frequency range indices in Constant Q Transform
- * @param f Target frequency
- * @return Pair of start and end indices
+ * @brief Constant Q engines selectable with fft.cqt.engine.
  */
-std::pair<size_t, size_t> find(float f);
+enum class Engine { Direct, Sparse, Multirate, Sliding, Symmetric };
 
 /**
- * @brief Initialize Constant Q Transform
+ * @brief Frequency-domain CQT kernel folded onto the half spectrum of a real FFT.
+ *
+ * For input spectrum X, the bin value is sum(Xr * a + Xi * b) + i * sum(Xr * c + Xi * d)
+ * over the listed half-spectrum indices.
+ */
+struct SparseKernel {
+  std::vector<int32_t> index;
+  std::vector<float> a, b, c, d;
+};
+
+/**
+ * @brief Recursion constants of one bin of the sliding engine.
+ *
+ * A bin runs three sliding DFTs over its kernel length: at its frequency w and at w -/+ 2pi / (length - 1).
+ * 0.5 * X(w) - 0.25 * (X(w - d) + X(w + d)) is the Hann-windowed value, so the window costs no extra
+ * time-domain work.
+ */
+struct SlidingBin {
+  size_t length = 0;
+  double rotRe[3], rotIm[3];   // e^(i w)
+  double tailRe[3], tailIm[3]; // e^(-i w (length - 1)), weight of the newest sample
+  double centerRe, centerIm;   // Phase shift to the window center times the Hann normalization
+};
+
+/**
+ * @brief Configuration a kernel set is built from.
+ */
+struct Settings {
+  int binsPerOctave = 0;
+  float minFreq = 0.f;
+  float maxFreq = 0.f;
+  int fftSize = 0;
+  float sampleRate = 0.f;
+  std::string engine;
+  std::string precision;
+  int threads = 0;
+
+  /**
+   * @brief Snapshot the current configuration
+   */
+  static Settings fromConfig();
+
+  bool operator==(const Settings&) const = default;
+};
+
+/**
+ * @brief Immutable, versioned set of Constant Q kernels and everything derived from them.
+ *
+ * Sets are built off-thread and published whole (see current()), so a reader that pins one
+ * sees frequencies, kernels and tables that belong together for as long as it holds it.
+ */
+struct Kernels {
+  Settings settings;
+  uint64_t version = 0; // Unique per built set, 0 for the empty set
+  Engine engine = Engine::Direct;
+
+  float Q = 0.f;
+  size_t bins = 0;
+  std::vector<float> frequencies;
+  std::vector<size_t> lengths;
+  std::vector<std::vector<float, AlignedAllocator<float, 32>>> reals;
+  std::vector<std::vector<float, AlignedAllocator<float, 32>>> imags;
+
+  // fp16 copies of reals/imags scaled to a unit peak, used by the time-domain engines when
+  // fft.cqt.precision is "half"; empty otherwise. halfScales restores each kernel's scale.
+  std::vector<std::vector<uint16_t, AlignedAllocator<uint16_t, 32>>> halfReals;
+  std::vector<std::vector<uint16_t, AlignedAllocator<uint16_t, 32>>> halfImags;
+  std::vector<float> halfScales;
+
+  // Right halves (center tap first) of reals/imags for the symmetric engine; the real part of a
+  // Morlet kernel is even around its center and the imaginary part odd
+  std::vector<std::vector<float, AlignedAllocator<float, 32>>> foldReals;
+  std::vector<std::vector<float, AlignedAllocator<float, 32>>> foldImags;
+
+  std::vector<SparseKernel> sparse;
+  size_t sparseSize = 0; // FFT size the sparse kernels were built for, 0 if none
+
+  std::vector<int> levels;     // Decimation level per bin (0 = full rate)
+  int levelCount = 1;          // Number of levels in use
+  std::vector<float> halfband; // Odd-offset taps (1, 3, 5, ...) of the half-band filter
+
+  std::vector<SlidingBin> slidingBins;
+
+  // Bin bounds of the chunks the pool splits the bins into
+  std::vector<size_t> partitions;
+
+  /**
+   * @brief Find frequency range indices
+   * @param f Target frequency
+   * @return Pair of start and end indices
+   */
+  std::pair<size_t, size_t> find(float f) const;
+};
+
+// Workers shared by both channels' CQT
+extern WorkPool pool;
+
+/**
+ * @brief Per-consumer state of the multirate engine: the input mix decimated by 2 per level.
+ */
+struct Multirate {
+  struct Stage {
+    std::vector<float> data; // Power-of-two ring
+    uint64_t written = 0;
+  };
+
+  std::vector<Stage> stages;
+  uint64_t cursor = 0; // Ring frame one past the last sample fed
+  uint64_t version = 0;
+  float gainMid = 0.f;
+  float gainSide = 0.f;
+
+  /**
+   * @brief Size the level rings for the kernels and restart feeding at end
+   */
+  void reset(const Kernels& kernels, uint64_t end, float mid, float side);
+
+  /**
+   * @brief Append a sample to a level, cascading decimated outputs to the next levels
+   */
+  void push(const Kernels& kernels, int level, float x);
+
+  /**
+   * @brief Feed all ring frames up to end
+   * @return false if the input was overwritten while reading
+   */
+  bool update(const Kernels& kernels, uint64_t end, float mid, float side);
+};
+
+/**
+ * @brief Per-consumer state of the sliding engine: the running DFTs of every bin.
+ */
+struct Sliding {
+  struct Sums {
+    double re[3] = {};
+    double im[3] = {};
+    uint64_t age = 0; // Recursive updates since the last direct seed
+  };
+
+  std::vector<Sums> sums;
+  std::vector<float, AlignedAllocator<float, 32>> input; // Mixed frames, fftSize + 1 of history first
+  uint64_t cursor = 0; // Ring frame one past the last sample fed
+  uint64_t version = 0;
+  float gainMid = 0.f;
+  float gainSide = 0.f;
+};
+
+/**
+ * @brief Pin the published kernel set
+ * @return Current set, never null (empty before init())
+ * @note Hold the pointer for a whole frame so every lookup uses the same set.
+ */
+std::shared_ptr<const Kernels> current();
+
+/**
+ * @brief Build a kernel set synchronously
+ * @param settings Configuration to build for
+ * @return New set with a fresh version
+ */
+std::shared_ptr<Kernels> build(const Settings& settings);
+
+/**
+ * @brief Build and publish the initial kernel set and start the background builder
  */
 void init();
 
+/**
+ * @brief Stop the background builder
+ */
+void cleanup();
+
+/**
+ * @brief Compute bin frequencies and Q and size the kernel tables
+ */
+void initBins(Kernels& kernels);
+
 /**
  * @brief Generate Mortlet wavelet kernel for bin
+ * @param kernels Set being built
  * @param bin Frequency bin index
  */
-void genMortletKernel(int bin);
+void genMortletKernel(Kernels& kernels, int bin);
 
 /**
- * @brief Generate all Constant Q kernels
+ * @brief Build the sparse frequency-domain kernels from the time-domain ones
  */
-void generate();
+void genSparseKernels(Kernels& kernels);
 
 /**
- * @brief Regenerate Constant Q kernels
- * @return true if successful
+ * @brief Generate all Constant Q kernels and tables of a set whose bins are initialized
+ */
+void generate(Kernels& kernels);
+
+/**
+ * @brief Build the half-precision kernel copies for the selected precision and engine
+ * @note The accuracy against fp32 is checked by `constant_q_test half`.
+ */
+void genHalfKernels(Kernels& kernels);
+
+/**
+ * @brief Keep the right half of every kernel for the symmetric engine
+ * @note Agreement with the full kernels is checked by `constant_q_test symmetric`.
+ */
+void genFoldedKernels(Kernels& kernels);
+
+/**
+ * @brief Derive the sliding DFT constants from the bin frequencies and kernel lengths
+ */
+void genSlidingBins(Kernels& kernels);
+
+/**
+ * @brief Design the half-band decimation filter
+ */
+void genHalfband(Kernels& kernels);
+
+/**
+ * @brief Assign every bin its decimation level for the selected engine
+ */
+void assignLevels(Kernels& kernels);
+
+/**
+ * @brief Size the worker pool from fft.cqt.threads (0 = half the hardware threads, at most 8)
+ */
+void configurePool(int threads);
+
+/**
+ * @brief Split the bins into contiguous chunks of roughly equal cost for the pool
+ */
+void partition(Kernels& kernels);
+
+/**
+ * @brief Run fn(bin) for every bin of a set, spread across the pool when it has workers
+ * @param kernels Set whose partitions to use
+ * @param fn Per-bin body; called concurrently for different bins
+ */
+void forEachBin(const Kernels& kernels, const std::function<void(size_t)>& fn);
+
+/**
+ * @brief Start building new kernels in the background if the configuration changed
+ * @return true if a rebuild was requested; current() keeps the old set until it is done
  */
 bool regenerate();
 
 /**
  * @brief Compute Constant Q Transform
- * @param inA Primary input signal buffer
- * @param inB Secondary input signal buffer
+ * @param kernels Pinned kernel set
+ * @param inA Primary input signal ring storage
+ * @param inB Secondary input signal ring storage
+ * @param end Absolute frame one past the newest sample to analyse (snapshot of the ring head)
  * @param gainA Gain applied to @p inA
  * @param gainB Gain applied to @p inB (ignored when |gainB| <= FLT_EPSILON)
  * @param out Output spectrum
  * @param phase Output phase values per frequency bin
  */
 template <typename Alloc>
-void compute(const std::vector<float, Alloc>& inA, const std::vector<float, Alloc>& inB, float gainA, float gainB,
-             std::vector<float>& out, std::vector<float>& phase);
+void compute(const Kernels& kernels, const std::vector<float, Alloc>& inA, const std::vector<float, Alloc>& inB,
+             uint64_t end, float gainA, float gainB, std::vector<float>& out, std::vector<float>& phase);
+
+/**
+ * @brief Compute Constant Q Transform from one FFT of the input and the sparse kernels
+ * @param kernels Pinned kernel set
+ * @param end Absolute frame one past the newest sample to analyse (snapshot of the ring head)
+ * @param gainMid Gain applied to the mid channel
+ * @param gainSide Gain applied to the side channel
+ * @param plan Real FFT plan of the current FFT size, executed on in/spectrum
+ * @param in Scratch input of FFT size samples
+ * @param spectrum Scratch output of FFT size / 2 + 1 bins
+ * @param out Output spectrum, same layout as compute()
+ * @param phase Output phase values per frequency bin
+ * @return false if the kernels do not match the current plans or the input was overwritten
+ * @note Caller must hold the FFT mutex guarding plan, in and spectrum.
+ */
+bool computeSparse(const Kernels& kernels, uint64_t end, float gainMid, float gainSide, fftwf_plan plan, float* in,
+                   fftwf_complex* spectrum, std::vector<float>& out, std::vector<float>& phase);
+
+/**
+ * @brief Compute Constant Q Transform with each octave's kernels on its decimated signal
+ * @param kernels Pinned kernel set
+ * @param state Decimation state owned by the calling thread
+ * @param end Absolute frame one past the newest sample to analyse (snapshot of the ring head)
+ * @param gainMid Gain applied to the mid channel
+ * @param gainSide Gain applied to the side channel
+ * @param out Output spectrum, same layout as compute()
+ * @param phase Output phase values per frequency bin
+ * @note Lower octaves lag by the accumulated half-band delay (halfbandTaps / 2 samples per level).
+ */
+void computeMultirate(const Kernels& kernels, Multirate& state, uint64_t end, float gainMid, float gainSide,
+                      std::vector<float>& out, std::vector<float>& phase);
+
+/**
+ * @brief Compute Constant Q Transform with kernels folded around their centers
+ * @param kernels Pinned kernel set
+ * @param end Absolute frame one past the newest sample to analyse (snapshot of the ring head)
+ * @param gainMid Gain applied to the mid channel
+ * @param gainSide Gain applied to the side channel
+ * @param out Output spectrum, same layout as compute()
+ * @param phase Output phase values per frequency bin
+ * @return false if the input was overwritten while reading or the kernels are missing
+ * @note Sums x[c + n] + x[c - n] and x[c + n] - x[c - n] before multiplying, halving the
+ *       multiplies and the kernel memory of compute().
+ */
+bool computeSymmetric(const Kernels& kernels, uint64_t end, float gainMid, float gainSide, std::vector<float>& out,
+                      std::vector<float>& phase);
+
+/**
+ * @brief Compute Constant Q Transform by sliding every bin's DFT over the frames since the last call
+ * @param kernels Pinned kernel set
+ * @param state Running sums owned by the calling thread
+ * @param end Absolute frame one past the newest sample to analyse (snapshot of the ring head)
+ * @param gainMid Gain applied to the mid channel
+ * @param gainSide Gain applied to the side channel
+ * @param out Output spectrum, same layout as compute()
+ * @param phase Output phase values per frequency bin
+ * @note Cost per call scales with the new frames, not the kernel lengths; bins whose window was fully
+ *       replaced since the last call are summed directly instead. Bins use a Hann window of their
+ *       kernel length rather than the Morlet envelope.
+ */
+void computeSliding(const Kernels& kernels, Sliding& state, uint64_t end, float gainMid, float gainSide,
+                    std::vector<float>& out, std::vector<float>& phase);
 
 } // namespace ConstantQ
 
@@ -160,22 +498,61 @@ void compute(const std::vector<float, Alloc>& inA, const std::vector<float, Allo
  * @brief FFT processing namespace
  */
 namespace FFT {
+
+// Maximum number of hops transformed in one batch, and the power-of-two plan count covering it
+constexpr size_t batchLevels = 5;
+constexpr size_t maxBatch = size_t(1) << (batchLevels - 1);
+
+// Maximum number of queued analysis frames
+constexpr size_t maxColumns = 64;
+
+// Window tables kept for switching back without recomputing; the cache is cleared beyond this
+constexpr size_t maxWindows = 8;
+
+// Shape parameter of the Kaiser analysis window (~-70 dB sidelobes)
+constexpr float kaiserBeta = 9.0f;
+
+/**
+ * @brief Precomputed analysis window.
+ */
+struct Window {
+  RingBuffer::Storage coeffs;
+  float gain = 1.0f; // Coherent gain (sum of coefficients), normalizes magnitudes to amplitude
+};
+
+/**
+ * @brief One analysis frame of the main channel, stamped with its position in the sample ring.
+ */
+struct Column {
+  uint64_t frame = 0; // Absolute ring frame one past the last analysed sample
+  std::vector<float> magnitude;
+  std::vector<float> phase;
+};
+
 extern std::mutex mutexMid;
 extern std::mutex mutexSide;
-extern fftwf_plan mid;
+// The FFTW planner and wisdom are not thread-safe; every plan/destroy/wisdom call holds this
+extern std::mutex plannerMutex;
+// mid[b] transforms 1 << b consecutive frames of inMid into outMid
+extern std::array<fftwf_plan, batchLevels> mid;
 extern fftwf_plan side;
 extern float* inMid;
 extern float* inSide;
 extern fftwf_complex* outMid;
 extern fftwf_complex* outSide;
+// packed[b] transforms 1 << b consecutive complex frames of packedData in place (packed engine only)
+extern std::array<fftwf_plan, batchLevels> packed;
+extern fftwf_complex* packedData;
+// Window for the current size and type, swapped only while both mutexes are held
+extern const Window* window;
 
 /**
- * @brief Initialize FFT plans
+ * @brief Load saved wisdom, start the background planner and create the initial plans
  */
 void init();
 
 /**
- * @brief Cleanup FFT resources
+ * @brief Stop the background planner and release FFT resources
  */
 void cleanup();
 
@@ -185,8 +562,252 @@ void cleanup();
  */
 bool recreatePlans();
 
+/**
+ * @brief Window and mix a span of the sample ring into an FFT input buffer
+ * @param span Frames to read, window->coeffs.size() long
+ * @param gainMid Weight of the mid channel
+ * @param gainSide Weight of the side channel
+ * @param out Destination of span.count samples
+ * @note Caller must hold the mutex guarding out; check ring.valid() afterwards.
+ */
+void prepareInput(const RingBuffer::Span& span, float gainMid, float gainSide, float* out);
+
+/**
+ * @brief Transform the first frames consecutive windows in inMid using the batched plans
+ * @param frames Number of windows, at most maxBatch
+ * @note Caller must hold mutexMid.
+ */
+void execute(size_t frames);
+
+/**
+ * @brief Get a frame to fill, reusing the buffers of dropped or consumed frames when there are any
+ */
+Column takeColumn();
+
+/**
+ * @brief Check whether the current plans were created for the packed engine
+ * @return true if both channels are transformed by FFTMain as one complex FFT
+ * @note Latched by createPlans() rather than read from the config, so it never reports packed buffers
+ *       that do not exist yet; hold mutexMid before relying on it for pack()/unpack().
+ */
+bool packedEngine();
+
+/**
+ * @brief Pack pairs of windows from inMid into packedData (first as real, second as imaginary) and transform them
+ * @param count Number of staged windows in inMid, at most maxBatch + 1
+ * @note Caller must hold mutexMid.
+ */
+void pack(size_t count);
+
+/**
+ * @brief Separate the two real spectra of a packed transform
+ * @param pair Index of the transform in packedData
+ * @param a Receives the spectrum of the real part (size / 2 + 1 bins)
+ * @param b Receives the spectrum of the imaginary part, may be nullptr
+ */
+void unpack(size_t pair, fftwf_complex* a, fftwf_complex* b);
+
+/**
+ * @brief Mark phase output as needed; call from the render path of every consumer of phase
+ */
+void requestPhase();
+
+/**
+ * @brief Check whether any consumer asked for phase recently
+ * @return true if phase should be computed
+ */
+bool phaseNeeded();
+
+/**
+ * @brief Convert a real FFT output to amplitude-normalized magnitudes and phases
+ * @param out FFT output of size / 2 + 1 bins
+ * @param size FFT size
+ * @param magnitude Destination magnitudes
+ * @param phase Destination phases in radians (approximate atan2, ~1e-5 rad), or nullptr to skip
+ */
+void toSpectrum(const fftwf_complex* out, size_t size, float* magnitude, float* phase);
+
+/**
+ * @brief Account time spent producing spectra, for comparing engines
+ * @param elapsed Time spent
+ * @param spectra Number of channel spectra produced
+ */
+void recordTiming(std::chrono::steady_clock::duration elapsed, size_t spectra);
+
+/**
+ * @brief Log the average cost per spectrum every few seconds (debug output)
+ */
+void reportTiming();
+
+/**
+ * @brief Queue an analysis frame for time-ordered consumers, dropping the oldest when full
+ * @param column Frame to publish, preferably obtained from takeColumn()
+ */
+void publish(Column&& column);
+
+/**
+ * @brief Take the oldest queued analysis frame
+ * @param column Receives the frame; its previous buffers are kept for reuse
+ * @return true if a frame was available
+ */
+bool popColumn(Column& column);
+
 } // namespace FFT
 
+/**
+ * @brief Spectrum display ballistics
+ */
+namespace Smoothing {
+
+/**
+ * @brief Persistent smoothing state for one spectrum
+ *
+ * The smoothed level is kept in dB between frames, so an update costs one log per bin. The linear
+ * output is either the raw value (target reached) or the previous output scaled by a per-frame gain,
+ * which avoids converting back with pow.
+ */
+struct State {
+  // Smoothed level per bin in dB
+  std::vector<float, AlignedAllocator<float, 32>> level;
+  // Seconds each bin has been held since it last rose
+  std::vector<float, AlignedAllocator<float, 32>> held;
+};
+
+/**
+ * @brief Move out toward raw at the configured rise/fall speeds, holding peaks if enabled
+ * @param state Per-spectrum state, reseeded when the bin count changes
+ * @param raw Latest magnitudes
+ * @param out Displayed magnitudes, resized to match raw
+ * @param dt Seconds since the previous update
+ * @note out must not be modified elsewhere between calls.
+ */
+void process(State& state, const std::vector<float>& raw, std::vector<float>& out, float dt);
+
+} // namespace Smoothing
+
+/**
+ * @brief Long-term spectrum accumulators (peak hold and averages) for tuning sessions
+ *
+ * The FFT threads fold in every analysed column, timed by its hop in audio frames, so the curves do
+ * not depend on how often the threads wake. The curves are published once per wake as immutable
+ * snapshots that renderers pin.
+ */
+namespace Accumulator {
+
+/**
+ * @brief Published accumulator curves, in linear magnitude like the raw spectra
+ */
+struct Curves {
+  // Peak hold with decay, empty when disabled
+  std::vector<float> peak;
+  // Exponential or linear power average, empty when disabled
+  std::vector<float> average;
+};
+
+/**
+ * @brief Accumulator state for one spectrum
+ */
+struct State {
+  std::vector<float, AlignedAllocator<float, 32>> peak;
+  // Exponential average of power
+  std::vector<float, AlignedAllocator<float, 32>> ema;
+  // Last frames of power for the linear average, frames x bins
+  std::vector<float, AlignedAllocator<float, 32>> history;
+  // Running sum of history, resummed every time the history wraps
+  std::vector<float, AlignedAllocator<float, 32>> sum;
+  size_t frames = 0;
+  size_t cursor = 0;
+  size_t filled = 0;
+
+  // Two snapshots published in turn, so a new one is only allocated while a renderer still pins the spare
+  std::shared_ptr<Curves> snapshots[2];
+  size_t spare = 0;
+
+  std::atomic<std::shared_ptr<const Curves>> published {std::make_shared<const Curves>()};
+};
+
+extern State mid;
+extern State side;
+
+/**
+ * @brief Fold one analysed column into the accumulators
+ * @param state Accumulator state of the spectrum, reseeded when the bin count or settings change
+ * @param raw Raw magnitudes of the column
+ * @param dt Audio seconds since the previous column (hop / sample rate)
+ * @note Nothing is published until publish() is called.
+ */
+void process(State& state, const std::vector<float>& raw, float dt);
+
+/**
+ * @brief Publish the current curves of a spectrum for the renderers
+ * @param state Accumulator state of the spectrum
+ */
+void publish(State& state);
+
+/**
+ * @brief Latest published curves of a spectrum (never null)
+ */
+std::shared_ptr<const Curves> current(const State& state);
+
+} // namespace Accumulator
+
+/**
+ * @brief Fundamental frequency tracking (McLeod pitch method)
+ *
+ * The normalized square difference function of a decimated mid window is computed through an FFT
+ * autocorrelation; the first key maximum above a fraction of the highest one gives the period, which
+ * favours the fundamental over its harmonics. A tracker with confidence hysteresis smooths the result.
+ */
+namespace Pitch {
+
+// Analysis rate the mid signal is decimated to, bounding the highest detectable pitch
+constexpr float analysisRate = 12000.f;
+// Analysis window at the decimated rate; lags up to half of it are searched
+constexpr size_t window = 1024;
+// Key maxima within this fraction of the highest NSDF peak are period candidates
+constexpr float keyThreshold = 0.9f;
+// Clarity needed to start tracking and to keep tracking a pitch
+constexpr float acquireClarity = 0.8f;
+constexpr float releaseClarity = 0.6f;
+// Pitches further than this from the tracked one need consecutive confirmations before being followed
+constexpr float jumpCents = 100.f;
+constexpr int jumpFrames = 3;
+// The last pitch is held for this long after tracking is lost
+constexpr float holdTime = 0.25f;
+
+/**
+ * @brief Published pitch estimate
+ */
+struct Estimate {
+  float frequency = 0.f;  // Hz, 0 when no pitch is tracked
+  float confidence = 0.f; // NSDF clarity of the tracked pitch in [0, 1]
+};
+
+/**
+ * @brief Allocate analysis buffers and plan the autocorrelation transforms
+ */
+void init();
+
+/**
+ * @brief Release the autocorrelation transforms
+ */
+void cleanup();
+
+/**
+ * @brief Analyse the newest window ending at end and publish the tracked estimate
+ * @param end Absolute end frame in the sample ring
+ * @param dt Seconds since the previous call
+ * @note Called from the main FFT thread only.
+ */
+void process(uint64_t end, float dt);
+
+/**
+ * @brief Latest published estimate; frequency and confidence always belong together
+ */
+Estimate current();
+
+} // namespace Pitch
+
 /**
  * @brief DSP processing threads namespace
  */
@@ -206,6 +827,13 @@ int FFTMain(std::stop_token stoken);
  */
 int FFTAlt(std::stop_token stoken);
 
+/**
+ * @brief Loudness worker, runs below normal priority so gating never delays the spectrum
+ * @param stoken Stop token provided by jthread
+ * @return Thread exit code
+ */
+int LUFSWorker(std::stop_token stoken);
+
 /**
  * @brief Main DSP processing thread
  * @param stoken Stop token provided by jthread
@@ -216,9 +844,165 @@ int mainThread(std::stop_token stoken);
 } // namespace Threads
 
 /**
- * @brief LUFS measurement using libebur128
+ * @brief Inter-sample peak estimation by polyphase oversampling (ITU-R BS.1770 Annex 2)
+ */
+namespace TruePeak {
+
+// Taps per polyphase branch; at 4x oversampling this is the 48-tap interpolator of BS.1770
+constexpr size_t phaseTaps = 12;
+constexpr size_t maxFactor = 4;
+constexpr float kaiserBeta = 6.0f;
+
+/**
+ * @brief Stereo polyphase interpolator.
+ *
+ * History rows hold one frame broadcast as [left x maxFactor | right x maxFactor], so one multiply-add
+ * per tap evaluates every branch of both channels. Rows are written twice, phaseTaps apart, which keeps
+ * the last phaseTaps frames contiguous. Unused branches have zero coefficients.
+ */
+struct Interpolator {
+  alignas(32) float coeffs[phaseTaps][2 * maxFactor] = {};
+  alignas(32) float history[2 * phaseTaps][2 * maxFactor] = {};
+  size_t pos = 0;
+  size_t factor = 1;
+
+  /**
+   * @brief Design the branches and clear the history
+   * @param oversampling Oversampling factor, clamped to [1, maxFactor]
+   */
+  void init(size_t oversampling);
+
+  /**
+   * @brief Interpolate a block of frames
+   * @param left Left channel samples
+   * @param right Right channel samples
+   * @param count Number of frames
+   * @param peakLeft Raised to the largest interpolated magnitude of the left channel
+   * @param peakRight Raised to the largest interpolated magnitude of the right channel
+   */
+  void process(const float* left, const float* right, size_t count, float& peakLeft, float& peakRight);
+};
+
+/**
+ * @brief Oversampling factor for a sample rate: 4x below 96 kHz, 2x below 192 kHz, none above
+ */
+size_t factorFor(float sampleRate);
+
+} // namespace TruePeak
+
+/**
+ * @brief LUFS measurement using libebur128 or the native BS.1770 meter, selected with lufs.engine
  */
 namespace LUFS {
+
+// Gating step of BS.1770 and the momentary (400 ms) and short-term (3 s) windows in steps
+constexpr float blockSeconds = 0.1f;
+constexpr size_t momentaryBlocks = 4;
+constexpr size_t shorttermBlocks = 30;
+
+// Gating histograms of the native engine: 0.1 LU bins from the absolute gate up to +30 LUFS
+constexpr float histogramMin = -70.0f;
+constexpr float histogramStep = 0.1f;
+constexpr size_t histogramBins = 1000;
+
+// Running window sums are recomputed from the block ring after this many blocks to bound rounding drift
+constexpr uint64_t resumBlocks = 600;
+
+/**
+ * @brief Loudness engines selectable with lufs.engine.
+ */
+enum class Engine { Libebur128, Native };
+
+/**
+ * @brief Loudness metrics of the native engine; loudness values are -inf until there is signal.
+ */
+struct Measurement {
+  float momentary = -INFINITY;                // LUFS over the last 400 ms
+  float shortterm = -INFINITY;                // LUFS over the last 3 s
+  float integrated = -INFINITY;               // Gated LUFS since init
+  float range = 0.0f;                         // Loudness range (EBU Tech 3342) in LU
+  float truePeak[2] = {-INFINITY, -INFINITY}; // Maximum left/right true peak since init in dBTP
+};
+
+/**
+ * @brief Block counts and summed block energies per loudness bin.
+ *
+ * Gating then walks the bins instead of every block of the session. Energies are kept exactly; only
+ * the bin a relative gate falls into is taken whole.
+ */
+struct Histogram {
+  std::array<uint64_t, histogramBins> count {};
+  std::array<double, histogramBins> energy {};
+  uint64_t total = 0;
+  double totalEnergy = 0.0;
+
+  static size_t binOf(float loudness) {
+    const float bin = std::floor((loudness - histogramMin) / histogramStep);
+    return static_cast<size_t>(std::clamp(bin, 0.0f, static_cast<float>(histogramBins - 1)));
+  }
+
+  /**
+   * @brief Count a block of the given mean square
+   */
+  void add(double e);
+
+  /**
+   * @brief Loudness of the mean energy of a bin
+   */
+  float loudness(size_t bin) const;
+};
+
+/**
+ * @brief Native BS.1770 / EBU Tech 3341-3342 meter behind lufs.engine "native".
+ *
+ * The K-weighted mean square of each 100 ms step is kept in a ring of the last 3 s, with running sums
+ * of the newest 4 (momentary) and 30 (short-term) entries. Every step then closes one 400 ms gating
+ * block and one short-term value, which go into the integrated and loudness range histograms.
+ */
+struct Meter {
+  // K-weighting stages (high shelf, RLB high-pass) in transposed direct form II, state per [stage][channel]
+  double b0[2] = {}, b1[2] = {}, b2[2] = {}, a1[2] = {}, a2[2] = {};
+  alignas(16) double s1[2][2] = {};
+  alignas(16) double s2[2][2] = {};
+
+  // Squared K-weighted samples of the step being filled, per channel
+  alignas(16) double sum[2] = {};
+  size_t blockLength = 1;
+  size_t blockFill = 0;
+
+  std::array<double, shorttermBlocks> blocks {};
+  size_t cursor = 0;
+  uint64_t completed = 0;
+  double momentarySum = 0.0;
+  double shorttermSum = 0.0;
+
+  Histogram gating;
+  Histogram range;
+
+  TruePeak::Interpolator truePeak;
+  float peak[2] = {};
+
+  /**
+   * @brief Design the weighting filters for a sample rate and clear the session
+   */
+  void init(float sampleRate);
+
+  /**
+   * @brief Measure a block of left/right frames
+   */
+  void process(const float* left, const float* right, size_t count);
+
+  /**
+   * @brief Close the current 100 ms step
+   */
+  void completeBlock();
+
+  /**
+   * @brief Loudness, range and true peak of the session so far
+   */
+  Measurement measure() const;
+};
+
 extern std::mutex mutex;
 extern ebur128_state* state;
 extern float lufs;
@@ -229,13 +1013,19 @@ extern float lufs;
 void init();
 
 /**
- * @brief Add audio samples for LUFS calculation from processed buffers
- * @param count Number of samples to process
+ * @brief Reinitialize after a config reload if lufs.engine or audio.sample_rate changed
+ */
+void reconfigure();
+
+/**
+ * @brief Feed frames published to the sample ring since the previous call into the LUFS meter
+ * @note Caller must hold mutex.
  */
-void addSamples(size_t count);
+void addSamples();
 
 /**
  * @brief Process LUFS calculation
+ * @note Caller must hold mutex.
  */
 void process();
 
@@ -244,26 +1034,75 @@ void process();
  */
 void reset();
 
+/**
+ * @brief Latest measurement of the native engine (never null; defaults with libebur128)
+ */
+std::shared_ptr<const Measurement> current();
+
 } // namespace LUFS
 
+/**
+ * @brief Sample peak meter with optional true-peak oversampling and hold/decay ballistics
+ */
 namespace Peak {
-extern float left;
-extern float right;
+
+// Samples at or above this magnitude count as clipped
+constexpr float clipLevel = 1.0f;
+
+/**
+ * @brief Published meter state; levels are linear magnitudes after ballistics.
+ */
+struct Levels {
+  float left = 0.0f;
+  float right = 0.0f;
+  uint64_t clipsLeft = 0; // Clipped samples since start
+  uint64_t clipsRight = 0;
+};
 
 /**
- * @brief Process peak detection
+ * @brief Measure every frame published since the previous call and publish new levels
  */
 void process();
 
+/**
+ * @brief Latest published levels (never null)
+ */
+std::shared_ptr<const Levels> current();
+
 } // namespace Peak
 
+/**
+ * @brief Level meter behind the VU: running-window RMS or VU ballistics, selected with vu.ballistics
+ */
 namespace RMS {
-extern float rms;
+
+// Running window sums are recomputed exactly after this many frames to bound rounding drift
+constexpr uint64_t resumFrames = uint64_t(1) << 20;
+
+// Second-order needle reaching 99% of a step in 300 ms with about 1.3% overshoot (IEC 60268-17)
+constexpr double vuOmega = 13.42;
+constexpr double vuDamping = 0.81;
+
+/**
+ * @brief Published levels, linear RMS (or RMS-calibrated VU readings).
+ */
+struct Levels {
+  float mid = 0.0f;
+  float left = 0.0f;
+  float right = 0.0f;
+  float stereo = 0.0f; // Power mean of left and right
+};
 
 /**
- * @brief Process RMS calculation.
+ * @brief Update the levels with the frames published since the previous call
  */
 void process();
+
+/**
+ * @brief Latest published levels (never null)
+ */
+std::shared_ptr<const Levels> current();
+
 } // namespace RMS
 
 } // namespace DSP
\ No newline at end of file
@@ -18,6 +18,7 @@
  */
 
 #pragma once
+#include "ring_buffer.hpp"
 #include "types.hpp"
 
 #include <memory>
@@ -25,7 +26,7 @@
 #include <stdint.h>
 #include <type_traits>
 
-#define PLUGIN_API_VERSION 6
+#define PLUGIN_API_VERSION 7
 
 #ifdef _WIN32
 #define PV_API extern "C" __declspec(dllexport)
@@ -272,14 +273,9 @@ struct PvAPI {
   Theme::Colors* theme;
 
   /**
-   * @brief Read-only pointer to main audio buffer.
+   * @brief Read-only pointer to the mid/side sample ring.
    */
-  const std::vector<float, AlignedAllocator<float, 32>>* bufferMid;
-
-  /**
-   * @brief Read-only pointer to side audio buffer.
-   */
-  const std::vector<float, AlignedAllocator<float, 32>>* bufferSide;
+  const DSP::RingBuffer* ring;
 
   /**
    * @brief Read-only pointer to raw main FFT buffer.
@@ -311,11 +307,6 @@ struct PvAPI {
    */
   const std::vector<float>* fftSidePhase;
 
-  /**
-   * @brief Read-only pointer to current ring-buffer write position.
-   */
-  const size_t* writePos;
-
   /**
    * @brief Read-only pointer to SDL window state map.
    */
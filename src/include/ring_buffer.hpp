@@ -0,0 +1,321 @@
+/*
+ * Pulse Audio Visualizer
+ * Copyright (C) 2025 Beacroxx
+ * Copyright (C) 2025 Contributors (see CONTRIBUTORS.md)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "types.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+namespace DSP {
+
+/**
+ * @brief Single-producer/multi-consumer ring buffer for mid/side audio frames.
+ *
+ * The producer (audio backend) is the only writer. It publishes a monotonically increasing
+ * frame counter with release semantics once a block is fully written, so any consumer that
+ * acquires the counter sees every frame before it. Consumers never block the producer; each
+ * one keeps its own cursor (see Reader) and may validate after reading that the frames it
+ * used were not overwritten in the meantime (seqlock style).
+ *
+ * Frame positions are absolute 64-bit counters; use index() to map them into the storage.
+ * The capacity is a power of two so wrapped arithmetic on size_t stays valid with mask().
+ */
+class RingBuffer {
+public:
+  using Storage = std::vector<float, AlignedAllocator<float, 32>>;
+
+  /**
+   * @brief Per-consumer read cursor.
+   */
+  struct Reader {
+    uint64_t cursor = 0;
+  };
+
+  /**
+   * @brief Range of absolute frames [begin, begin + count).
+   */
+  struct Span {
+    uint64_t begin = 0;
+    size_t count = 0;
+
+    uint64_t end() const { return begin + count; }
+  };
+
+  /**
+   * @brief Allocate storage and reset all cursors.
+   * @param frames Requested capacity, rounded up to a power of two
+   * @note Not thread-safe; call before the producer and consumers are started.
+   */
+  void resize(size_t frames) {
+    size_t cap = 1;
+    while (cap < frames)
+      cap <<= 1;
+    midData.assign(cap, 0.0f);
+    sideData.assign(cap, 0.0f);
+    mask_ = cap - 1;
+    written.store(0, std::memory_order_relaxed);
+    reserved.store(0, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return midData.size(); }
+  size_t mask() const { return mask_; }
+
+  /**
+   * @brief Map an absolute frame (or any wrapped offset from one) to a storage index.
+   */
+  size_t index(uint64_t frame) const { return static_cast<size_t>(frame) & mask_; }
+
+  /**
+   * @brief Total number of frames published so far (acquire).
+   */
+  uint64_t head() const { return written.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Storage index one past the most recent published frame.
+   */
+  size_t writePos() const { return index(head()); }
+
+  const Storage& mid() const { return midData; }
+  const Storage& side() const { return sideData; }
+
+  /**
+   * @brief Write count frames and publish them.
+   * @param count Number of frames to write
+   * @param fn Callback invoked once per contiguous segment as fn(mid, side, offset, length),
+   *           where offset is the position of the segment within the block
+   * @note Producer only.
+   */
+  template <typename Fn> void produce(size_t count, Fn&& fn) {
+    if (count == 0 || midData.empty())
+      return;
+
+    const uint64_t start = written.load(std::memory_order_relaxed);
+    const uint64_t end = start + count;
+
+    // Announce the region about to be overwritten before touching it
+    reserved.store(end, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Only the newest capacity frames can survive, skip the rest
+    size_t done = count > capacity() ? count - capacity() : 0;
+    while (done < count) {
+      const size_t pos = index(start + done);
+      const size_t len = std::min(count - done, capacity() - pos);
+      fn(midData.data() + pos, sideData.data() + pos, done, len);
+      done += len;
+    }
+
+    written.store(end, std::memory_order_release);
+  }
+
+  /**
+   * @brief Write count frames of silence.
+   * @note Producer only.
+   */
+  void fill(size_t count, float value = 0.0f) {
+    produce(count, [value](float* mid, float* side, size_t, size_t len) {
+      std::fill_n(mid, len, value);
+      std::fill_n(side, len, value);
+    });
+  }
+
+  /**
+   * @brief Return the frames published since the reader's last poll and advance it.
+   * @param reader Consumer cursor
+   * @param maxFrames Upper bound on returned frames; older frames are dropped if the reader lagged
+   * @return Span of new frames (count may be 0)
+   */
+  Span poll(Reader& reader, size_t maxFrames) const {
+    const uint64_t end = head();
+    uint64_t begin = reader.cursor;
+    const uint64_t limit = std::min<uint64_t>(maxFrames, capacity());
+    if (begin > end || end - begin > limit)
+      begin = end - std::min<uint64_t>(limit, end);
+    reader.cursor = end;
+    return {begin, static_cast<size_t>(end - begin)};
+  }
+
+  /**
+   * @brief Latest count frames ending at end, fewer if the stream has not produced that many yet.
+   */
+  Span latest(uint64_t end, size_t count) const {
+    count = static_cast<size_t>(std::min<uint64_t>({count, capacity(), end}));
+    return {end - count, count};
+  }
+
+  /**
+   * @brief Check whether frames from begin onward were left untouched by the producer.
+   *
+   * Call after reading; a false result means the producer lapped the reader and the data
+   * read must be considered torn.
+   */
+  bool valid(uint64_t begin) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return reserved.load(std::memory_order_relaxed) <= begin + capacity();
+  }
+
+  /**
+   * @brief Visit a span as at most two contiguous segments.
+   * @param span Frames to visit
+   * @param fn Callback invoked as fn(mid, side, offset, length)
+   * @return true if the span was not overwritten while visiting
+   */
+  template <typename Fn> bool read(Span span, Fn&& fn) const {
+    size_t done = 0;
+    while (done < span.count) {
+      const size_t pos = index(span.begin + done);
+      const size_t len = std::min(span.count - done, capacity() - pos);
+      fn(midData.data() + pos, sideData.data() + pos, done, len);
+      done += len;
+    }
+    return valid(span.begin);
+  }
+
+  /**
+   * @brief Copy a span into linear buffers.
+   * @param span Frames to copy
+   * @param outMid Destination for mid samples (may be nullptr)
+   * @param outSide Destination for side samples (may be nullptr)
+   * @return true if the copy is a consistent snapshot
+   */
+  bool copy(Span span, float* outMid, float* outSide) const {
+    return read(span, [outMid, outSide](const float* mid, const float* side, size_t offset, size_t len) {
+      if (outMid)
+        std::memcpy(outMid + offset, mid, len * sizeof(float));
+      if (outSide)
+        std::memcpy(outSide + offset, side, len * sizeof(float));
+    });
+  }
+
+private:
+  Storage midData;
+  Storage sideData;
+  size_t mask_ = 0;
+
+  // Frames fully written and visible to consumers
+  alignas(64) std::atomic<uint64_t> written {0};
+  // Frames the producer has started writing; written <= reserved
+  alignas(64) std::atomic<uint64_t> reserved {0};
+};
+
+/**
+ * @brief Single-producer/single-consumer ring of interleaved stereo frames.
+ *
+ * Used to hand raw backend buffers from a realtime callback to the DSP thread: the producer
+ * only copies, the consumer does the conversion. Unlike RingBuffer the producer never
+ * overwrites unread data; frames that do not fit are dropped and counted.
+ */
+class StagingRing {
+public:
+  static constexpr size_t channels = 2;
+
+  /**
+   * @brief Allocate storage for at least the given number of frames and reset cursors.
+   * @note Not thread-safe; call while neither side is running.
+   */
+  void resize(size_t frames) {
+    size_t cap = 1;
+    while (cap < frames)
+      cap <<= 1;
+    data.assign(cap * channels, 0.0f);
+    mask_ = cap - 1;
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_relaxed);
+  }
+
+  size_t capacity() const { return data.size() / channels; }
+
+  /**
+   * @brief Copy interleaved frames into the ring.
+   * @param samples Interleaved input
+   * @param frames Number of frames
+   * @return Number of frames accepted
+   * @note Producer only; wait-free, performs no allocation.
+   */
+  size_t write(const float* samples, size_t frames) {
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    const uint64_t t = tail.load(std::memory_order_acquire);
+    const size_t n = std::min<size_t>(frames, capacity() - static_cast<size_t>(h - t));
+    if (n < frames)
+      dropped.fetch_add(frames - n, std::memory_order_relaxed);
+
+    size_t done = 0;
+    while (done < n) {
+      const size_t pos = static_cast<size_t>(h + done) & mask_;
+      const size_t len = std::min(n - done, capacity() - pos);
+      std::memcpy(data.data() + pos * channels, samples + done * channels, len * channels * sizeof(float));
+      done += len;
+    }
+
+    head.store(h + n, std::memory_order_release);
+    return n;
+  }
+
+  /**
+   * @brief Hand all pending frames to fn and release them.
+   * @param fn Callback invoked once per contiguous segment as fn(samples, frames)
+   * @return Number of frames consumed
+   * @note Consumer only.
+   */
+  template <typename Fn> size_t consume(Fn&& fn) {
+    const uint64_t t = tail.load(std::memory_order_relaxed);
+    const uint64_t h = head.load(std::memory_order_acquire);
+    const size_t count = static_cast<size_t>(h - t);
+
+    size_t done = 0;
+    while (done < count) {
+      const size_t pos = static_cast<size_t>(t + done) & mask_;
+      const size_t len = std::min(count - done, capacity() - pos);
+      fn(data.data() + pos * channels, len);
+      done += len;
+    }
+
+    tail.store(h, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Number of frames available to the consumer.
+   */
+  size_t pending() const {
+    return static_cast<size_t>(head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed));
+  }
+
+  /**
+   * @brief Total frames dropped because the consumer fell behind.
+   */
+  uint64_t overruns() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+  RingBuffer::Storage data;
+  size_t mask_ = 0;
+
+  alignas(64) std::atomic<uint64_t> head {0};
+  alignas(64) std::atomic<uint64_t> tail {0};
+  std::atomic<uint64_t> dropped {0};
+};
+
+// Shared mid/side sample ring filled by the audio backend
+extern RingBuffer ring;
+
+} // namespace DSP
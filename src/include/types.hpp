@@ -271,6 +271,10 @@ struct Options {
     bool flip_x = false;
     bool markers = true;
     int size = 4096;
+    int hop = 512;
+    std::string window = "hann";
+    std::string planner = "measure";
+    std::string engine = "split";
     float slope = 3.0f;
     std::string key = "sharp";
     std::string mode = "midside";
@@ -290,11 +294,23 @@ struct Options {
       float fall_speed = 50.0f;
       float hover_fall_speed = 10.0f;
       float rise_speed = 500.0f;
+      float hold_time = 0.0f;
     } smoothing;
 
+    struct Accumulator {
+      bool peak_hold = false;
+      float peak_decay = 3.0f;
+      std::string average = "none";
+      float average_time = 5.0f;
+      int average_frames = 100;
+    } accumulator;
+
     struct CQT {
       int bins_per_octave = 60;
       bool enabled = true;
+      std::string engine = "direct";
+      int threads = 0;
+      std::string precision = "float";
     } cqt;
 
     struct Sphere {
@@ -331,6 +347,7 @@ struct Options {
     float silence_threshold = -100.0f;
     float sample_rate = 44100.0f;
     float gain_db = 0.0f;
+    float latency = 10.0f;
     std::string engine = "auto";
     std::string device = "default";
   } audio;
@@ -385,12 +402,20 @@ struct Options {
   } phosphor;
 
   struct LUFS {
+    std::string engine = "libebur128";
     std::string mode = "momentary";
     std::string scale = "linear";
     std::string label = "off";
+
+    struct Peak {
+      bool true_peak = false;
+      float hold_time = 0.0f;
+      float decay = 0.0f;
+    } peak;
   } lufs;
 
   struct VU {
+    std::string ballistics = "window";
     float window = 100.0f;
     std::string style = "digital";
     float calibration_db = 0.0f;
@@ -413,9 +438,7 @@ struct Options {
 } // namespace Config
 
 namespace DSP {
-// Audio buffer data
-extern std::vector<float, AlignedAllocator<float, 32>> bufferMid;
-extern std::vector<float, AlignedAllocator<float, 32>> bufferSide;
+// Filtered audio, indexed like the sample ring (see ring_buffer.hpp)
 extern std::vector<float, AlignedAllocator<float, 32>> bandpassed;
 extern std::vector<float, AlignedAllocator<float, 32>> lowpassed;
 
@@ -427,8 +450,8 @@ extern std::vector<float> fftSideRaw;
 extern std::vector<float> fftSide;
 extern std::vector<float> fftSidePhase;
 
+// Maximum history (in frames) consumers may read behind the ring head
 extern const size_t bufferSize;
-extern size_t writePos;
 } // namespace DSP
 
 namespace Theme {
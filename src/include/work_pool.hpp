@@ -0,0 +1,88 @@
+/*
+ * Pulse Audio Visualizer
+ * Copyright (C) 2025 Beacroxx
+ * Copyright (C) 2025 Contributors (see CONTRIBUTORS.md)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "common.hpp"
+
+namespace DSP {
+
+/**
+ * @brief Persistent work-stealing thread pool for data-parallel loops.
+ *
+ * run() splits a job's tasks into one contiguous range per participant (the calling thread
+ * plus every worker). Each participant drains its own range and then steals single tasks from
+ * the others' ranges, so a skewed range does not stall the job. The caller always takes part,
+ * which keeps jobs completing while the pool is being resized and makes a pool of size 0 run
+ * everything inline. Several threads may run jobs concurrently.
+ */
+class WorkPool {
+public:
+  WorkPool() = default;
+  WorkPool(const WorkPool&) = delete;
+  WorkPool& operator=(const WorkPool&) = delete;
+  ~WorkPool();
+
+  /**
+   * @brief Set the number of worker threads, joining or spawning as needed
+   * @param workers Worker count, not counting the calling thread
+   */
+  void resize(size_t workers);
+
+  /**
+   * @brief Number of worker threads
+   */
+  size_t size() const { return count.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Run fn(task) for every task in [0, tasks) and wait for all of them
+   * @param tasks Number of tasks
+   * @param fn Task body; must be safe to call concurrently for different tasks
+   */
+  void run(size_t tasks, const std::function<void(size_t)>& fn);
+
+private:
+  struct Range {
+    alignas(64) std::atomic<size_t> next {0};
+    size_t end = 0;
+  };
+
+  struct Job {
+    const std::function<void(size_t)>* fn = nullptr;
+    std::unique_ptr<Range[]> ranges;
+    size_t participants = 0;
+    size_t tasks = 0;
+    std::atomic<size_t> joined {1}; // Slot 0 belongs to the caller
+    std::atomic<size_t> done {0};
+  };
+
+  /**
+   * @brief Execute tasks of job starting with range slot, then steal, until none are left
+   */
+  static void participate(Job& job, size_t slot);
+
+  void workerMain(std::stop_token stoken);
+
+  std::mutex mutex;
+  std::condition_variable_any wake;
+  std::deque<std::shared_ptr<Job>> jobs;
+  std::vector<std::jthread> workers;
+  std::atomic<size_t> count {0};
+};
+
+} // namespace DSP
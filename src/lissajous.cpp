@@ -29,6 +29,9 @@ namespace Lissajous {
 class LissajousVisualizer : public WindowManager::VisualizerWindow {
 public:
   std::vector<std::pair<float, float>> points;
+  // Frames copied out of the ring for this render
+  std::vector<float> midSamples;
+  std::vector<float> sideSamples;
 
   LissajousVisualizer() {
     id = "lissajous";
@@ -42,15 +45,11 @@ public:
 std::shared_ptr<WindowManager::VisualizerWindow> createVisualizer() { return std::make_shared<LissajousVisualizer>(); }
 
 void LissajousVisualizer::render() {
-  // Calculate how many samples to read based on buffer position
-  static size_t prevWrite = 0;
-
-  size_t readCount = (DSP::writePos + DSP::bufferSize - prevWrite) % DSP::bufferSize;
-  prevWrite = DSP::writePos;
-
-  // Sane limit to avoid lag (5x expected samples)
-  if (readCount > Config::options.audio.sample_rate / Config::options.window.fps_limit * 5)
-    readCount = Config::options.audio.sample_rate / Config::options.window.fps_limit * 5;
+  // Calculate how many samples to read based on frames published since the last frame,
+  // with a sane limit to avoid lag (5x expected samples)
+  static DSP::RingBuffer::Reader reader;
+  size_t readCount =
+      DSP::ring.poll(reader, Config::options.audio.sample_rate / Config::options.window.fps_limit * 5).count;
 
   // Compensate for gap created with the shader's line drawing algo and potentially the catmull-rom spline
   readCount++;
@@ -59,16 +58,20 @@ void LissajousVisualizer::render() {
     readCount += 3;
   }
 
+  // Copy the frames out of the ring, dropping this frame if there are none yet or the producer lapped us
+  const DSP::RingBuffer::Span span = DSP::ring.latest(reader.cursor, readCount);
+  midSamples.resize(span.count);
+  sideSamples.resize(span.count);
+  if (span.count == 0 || !DSP::ring.copy(span, midSamples.data(), sideSamples.data()))
+    return;
+
   // Resize points vector to hold new data
-  points.resize(readCount);
+  points.resize(span.count);
 
   // Convert audio samples to Lissajous coordinates
-  size_t start = (DSP::bufferSize + DSP::writePos - readCount) % DSP::bufferSize;
-  for (size_t i = 0; i < readCount; i++) {
-    size_t idx = (start + i) % DSP::bufferSize;
-
-    float left = DSP::bufferMid[idx] + DSP::bufferSide[idx];
-    float right = DSP::bufferMid[idx] - DSP::bufferSide[idx];
+  for (size_t i = 0; i < span.count; i++) {
+    float left = midSamples[i] + sideSamples[i];
+    float right = midSamples[i] - sideSamples[i];
 
     // Basic mapping to screen coordinates
     float x = (1.f + left) * bounds.w / 2.f;
@@ -132,10 +132,11 @@ void LUFSVisualizer::render() {
   }
 
   // Draw peak bars
-  if (DSP::Peak::left > 0.0f || DSP::Peak::right > 0.0f) {
+  const std::shared_ptr<const DSP::Peak::Levels> peak = DSP::Peak::current();
+  if (peak->left > 0.0f || peak->right > 0.0f) {
     // Convert peak values to dB (amplitude to dB relative to full scale)
-    float leftDB = DSP::Peak::left > 0.0f ? 20.0f * log10f(DSP::Peak::left) : -70.0f;
-    float rightDB = DSP::Peak::right > 0.0f ? 20.0f * log10f(DSP::Peak::right) : -70.0f;
+    float leftDB = peak->left > 0.0f ? 20.0f * log10f(peak->left) : -70.0f;
+    float rightDB = peak->right > 0.0f ? 20.0f * log10f(peak->right) : -70.0f;
 
     // Clamp to -70dB minimum
     float clampedLeftDB = std::max(-70.0f, leftDB);
@@ -150,11 +151,44 @@ void LUFSVisualizer::render() {
     size_t leftBarY = bounds.h - (topHeight + barHeight);
     size_t rightBarY = bounds.h - (topHeight + barHeight);
 
+    // Light a bar in the clip color for a second after its channel clipped
+    static uint64_t lastClips[2] = {peak->clipsLeft, peak->clipsRight};
+    static uint64_t clipUntil[2] = {};
+    const uint64_t now = SDL_GetTicks();
+    const uint64_t clips[2] = {peak->clipsLeft, peak->clipsRight};
+    for (size_t ch = 0; ch < 2; ch++) {
+      if (clips[ch] != lastClips[ch])
+        clipUntil[ch] = now + 1000;
+      lastClips[ch] = clips[ch];
+    }
+    const float* clipColor = Theme::colors.vu_clip[3] > FLT_EPSILON ? Theme::colors.vu_clip : color;
+
     // Draw left peak bar
-    Graphics::drawFilledRect(leftPeakX, leftBarY, PEAK_BAR_WIDTH, leftBarHeight, color);
+    Graphics::drawFilledRect(leftPeakX, leftBarY, PEAK_BAR_WIDTH, leftBarHeight,
+                             now < clipUntil[0] ? clipColor : color);
 
     // Draw right peak bar
-    Graphics::drawFilledRect(rightPeakX, rightBarY, PEAK_BAR_WIDTH, rightBarHeight, color);
+    Graphics::drawFilledRect(rightPeakX, rightBarY, PEAK_BAR_WIDTH, rightBarHeight,
+                             now < clipUntil[1] ? clipColor : color);
+  }
+
+  // Session statistics of the native meter in the top area, as many lines as fit
+  if (Config::options.lufs.label == "on") {
+    const std::shared_ptr<const DSP::LUFS::Measurement> stats = DSP::LUFS::current();
+    if (std::isfinite(stats->integrated)) {
+      char lines[3][24];
+      snprintf(lines[0], sizeof(lines[0]), "I %.1f", stats->integrated);
+      snprintf(lines[1], sizeof(lines[1]), "LRA %.1f", stats->range);
+      snprintf(lines[2], sizeof(lines[2]), "TP %.1f", std::max(stats->truePeak[0], stats->truePeak[1]));
+      float textY = bounds.h;
+      for (const char* line : lines) {
+        auto [w, h] = Graphics::Font::getTextSize(line, FONT_SIZE_LABELS);
+        textY -= h + 2;
+        if (textY < barHeight)
+          break;
+        Graphics::Font::drawText(line, lufsBarX + LUFS_BAR_WIDTH + 2, textY, FONT_SIZE_LABELS, Theme::colors.text);
+      }
+    }
   }
 
   // Draw LUFS bar if value is valid
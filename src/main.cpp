@@ -109,11 +109,11 @@ void reconfigure() {
   DSP::FFT::recreatePlans();
   DSP::ConstantQ::regenerate();
   DSP::Lowpass::reconfigure();
-  DSP::LUFS::init();
+  DSP::LUFS::reconfigure();
 }
 
 // Thread synchronization
-std::binary_semaphore mainSem {0};
+Wakeup mainWake;
 
 int main(int argc, char** argv) {
   for (int i = 0; i < argc; i++) {
@@ -181,11 +181,11 @@ int main(int argc, char** argv) {
     FreeConsole();
 #endif
 
-  // Initialize DSP buffers
-  DSP::bufferMid.resize(DSP::bufferSize);
-  DSP::bufferSide.resize(DSP::bufferSize);
-  DSP::bandpassed.resize(DSP::bufferSize);
-  DSP::lowpassed.resize(DSP::bufferSize);
+  // Initialize DSP buffers, the ring keeps headroom so readers of the last bufferSize frames
+  // are not overwritten while the producer keeps writing
+  DSP::ring.resize(DSP::bufferSize * 2);
+  DSP::bandpassed.resize(DSP::ring.capacity());
+  DSP::lowpassed.resize(DSP::ring.capacity());
 
   // Setup configuration
   logDebug("Copying Files");
@@ -224,8 +224,9 @@ int main(int argc, char** argv) {
   logDebug("Initializing audio and DSP components");
   AudioEngine::init();
   DSP::ConstantQ::init();
-  DSP::ConstantQ::generate();
   DSP::FFT::init();
+  DSP::Pitch::init();
+  DSP::FIR::init();
   DSP::Lowpass::init();
   DSP::LUFS::init();
 
@@ -310,8 +311,17 @@ int main(int argc, char** argv) {
 
       WindowManager::updateBounds();
 
-      // Wait for DSP data to be ready
-      mainSem.try_acquire_for(100ms);
+      // Pace rendering to the frame rate limit, independently of the DSP cadence
+      static auto lastFrame = std::chrono::steady_clock::now();
+      std::this_thread::sleep_until(lastFrame +
+                                    std::chrono::duration<double>(1.0 / Config::options.window.fps_limit));
+
+      // Wait for DSP data to be ready, so frames are never drawn faster than audio arrives
+      mainWake.waitFor(100ms);
+
+      auto now = std::chrono::steady_clock::now();
+      WindowManager::dt = std::chrono::duration<float>(now - lastFrame).count();
+      lastFrame = now;
 
       // Render frame
       SDLWindow::clear();
@@ -348,6 +358,9 @@ int main(int argc, char** argv) {
   Graphics::Font::cleanup();
   AudioEngine::cleanup();
   DSP::FFT::cleanup();
+  DSP::Pitch::cleanup();
+  DSP::FIR::cleanup();
+  DSP::ConstantQ::cleanup();
   Config::cleanup();
   Theme::cleanup();
   SDLWindow::deinit();
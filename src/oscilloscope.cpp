@@ -30,6 +30,8 @@ namespace Oscilloscope {
 class OscilloscopeVisualizer : public WindowManager::VisualizerWindow {
 public:
   std::vector<std::pair<float, float>> points;
+  // Trace samples copied out of the ring for this render
+  std::vector<float> trace;
 
   OscilloscopeVisualizer() {
     id = "oscilloscope";
@@ -44,43 +46,75 @@ std::shared_ptr<WindowManager::VisualizerWindow> createVisualizer() {
 }
 
 void OscilloscopeVisualizer::render() {
+  // Pin one pitch estimate so the window length and the trigger agree
+  const float pitch = DSP::Pitch::current().frequency;
+
   // Calculate number of samples to display
   size_t samples = Config::options.oscilloscope.window * Config::options.audio.sample_rate / 1000;
-  if (Config::options.oscilloscope.pitch.cycles > 0 && DSP::pitch > FLT_EPSILON) {
-    samples = Config::options.audio.sample_rate / DSP::pitch * Config::options.oscilloscope.pitch.cycles;
+  if (Config::options.oscilloscope.pitch.cycles > 0 && pitch > FLT_EPSILON) {
+    samples = Config::options.audio.sample_rate / pitch * Config::options.oscilloscope.pitch.cycles;
     samples = std::max(samples, static_cast<size_t>(Config::options.oscilloscope.pitch.min_cycle_time *
                                                     Config::options.audio.sample_rate / 1000.0f));
   }
 
-  // Calculate target position in buffer
+  // Never show more than the readable history
+  samples = std::min<size_t>(samples, DSP::bufferSize);
+
+  // Calculate the target frame, snapshotting the ring head once so the trigger search
+  // and the trace refer to the same frames. Drop the frame until enough audio arrived.
+  const uint64_t head = DSP::ring.head();
   const size_t fir_delay = DSP::FIR::bandpass_filter.order / 2;
-  size_t target = (DSP::writePos + DSP::bufferSize - samples - fir_delay);
-  size_t range = Config::options.audio.sample_rate / DSP::pitch * 2.f;
-  size_t zeroCross = target;
+  if (head <= samples + fir_delay)
+    return;
+  uint64_t target = head - samples - fir_delay;
+  size_t range = pitch > FLT_EPSILON ? Config::options.audio.sample_rate / pitch * 2.f : 0;
+  uint64_t zeroCross = target;
 
   // Align to zero crossings if pitch following is enabled
   if (Config::options.oscilloscope.pitch.follow) {
     if (Config::options.oscilloscope.pitch.alignment == "center")
-      target = (target + samples / 2) % DSP::bufferSize;
+      target += samples / 2;
     else if (Config::options.oscilloscope.pitch.alignment == "right")
-      target = (target + samples) % DSP::bufferSize;
+      target += samples;
 
     // Find zero crossing point
-    for (uint32_t i = 0; i < range && i < DSP::bufferSize; i++) {
-      size_t pos = (target + DSP::bufferSize - i) % DSP::bufferSize;
-      size_t prev = (pos + DSP::bufferSize - 1) % DSP::bufferSize;
+    const size_t searched = static_cast<size_t>(std::min<uint64_t>({range, DSP::bufferSize, target - 1}));
+    for (size_t i = 0; i < searched; i++) {
+      size_t pos = DSP::ring.index(target - i);
+      size_t prev = DSP::ring.index(target - i - 1);
       if (DSP::bandpassed[prev] < 0.f && DSP::bandpassed[pos] >= 0.f) {
-        zeroCross = pos;
+        zeroCross = target - i;
         break;
       }
     }
 
+    // The bandpassed history trails the ring, so the ring tells whether it was overwritten meanwhile
+    if (!DSP::ring.valid(target - searched))
+      return;
+
     // Apply phase offset for peak alignment
-    size_t phaseOffset = (target + DSP::bufferSize - zeroCross) % DSP::bufferSize;
-    if (Config::options.oscilloscope.pitch.type == "peak")
-      phaseOffset += Config::options.audio.sample_rate / DSP::pitch * 0.75f;
-    target = (DSP::writePos + DSP::bufferSize - phaseOffset - samples) % DSP::bufferSize;
+    size_t phaseOffset = target - zeroCross;
+    if (Config::options.oscilloscope.pitch.type == "peak" && pitch > FLT_EPSILON)
+      phaseOffset += Config::options.audio.sample_rate / pitch * 0.75f;
+    if (head <= phaseOffset + samples + fir_delay)
+      return;
+    target = head - phaseOffset - samples;
+  }
+
+  // Copy the trace out of the ring and drop the frame if the producer lapped us
+  const uint64_t first = target - fir_delay;
+  trace.resize(samples);
+  if (Config::options.debug.show_bandpassed) [[unlikely]] {
+    for (size_t i = 0; i < samples; i++)
+      trace[i] = DSP::bandpassed[DSP::ring.index(first + i)];
+  } else if (Config::options.oscilloscope.lowpass.enabled) {
+    for (size_t i = 0; i < samples; i++)
+      trace[i] = DSP::lowpassed[DSP::ring.index(first + i + DSP::FIR::bandpass_filter.order / 4)];
+  } else if (!DSP::ring.copy({first, samples}, trace.data(), nullptr)) {
+    return;
   }
+  if (!DSP::ring.valid(first))
+    return;
 
   // Generate oscilloscope points
   points.resize(samples);
@@ -96,9 +130,7 @@ void OscilloscopeVisualizer::render() {
                      : bounds.h;
 
   for (size_t i = 0; i < samples; i++) {
-    size_t pos = (target + i - fir_delay) % DSP::bufferSize;
     float x = static_cast<float>(i) * scale;
-    float y;
 
     float mul = 1.0f;
     if (Config::options.oscilloscope.edge_compression.enabled) {
@@ -111,14 +143,7 @@ void OscilloscopeVisualizer::render() {
       mul = xNorm * xNorm * (3.0f - 2.0f * xNorm);
     }
 
-    // Choose between bandpassed or raw audio data
-    if (Config::options.debug.show_bandpassed) [[unlikely]]
-      y = height * 0.5f + DSP::bandpassed[pos] * mul * 0.5f * height - 0.5f;
-    else if (Config::options.oscilloscope.lowpass.enabled)
-      y = height * 0.5f +
-          DSP::lowpassed[(pos + DSP::FIR::bandpass_filter.order / 4) % DSP::bufferSize] * mul * 0.5f * height - 0.5f;
-    else
-      y = height * 0.5f + DSP::bufferMid[pos] * mul * 0.5f * height - 0.5f;
+    float y = height * 0.5f + trace[i] * mul * 0.5f * height - 0.5f;
 
     if (Config::options.oscilloscope.flip_x)
       y = height - y;
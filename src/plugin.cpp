@@ -66,15 +66,13 @@ PvAPI api {
     .setConfigOptionValue = Config::setPluginConfigOption,
     .config = &Config::options,
     .theme = &Theme::colors,
-    .bufferMid = &DSP::bufferMid,
-    .bufferSide = &DSP::bufferSide,
+    .ring = &DSP::ring,
     .fftMidRaw = &DSP::fftMidRaw,
     .fftMid = &DSP::fftMid,
     .fftMidPhase = &DSP::fftMidPhase,
     .fftSideRaw = &DSP::fftSideRaw,
     .fftSide = &DSP::fftSide,
     .fftSidePhase = &DSP::fftSidePhase,
-    .writePos = &DSP::writePos,
     .states = &SDLWindow::states,
     .debug = &CmdlineArgs::debug,
 };
@@ -211,6 +209,10 @@ void unloadAll() {
 }
 
 void drawAll() {
+  // Plugins may read fftMidPhase/fftSidePhase, so keep phase available while any are loaded
+  if (!plugins.empty())
+    DSP::FFT::requestPhase();
+
   for (auto& pl : plugins) {
     if (pl.draw)
       pl.draw();
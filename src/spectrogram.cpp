@@ -38,7 +38,8 @@ public:
     phosphor.unused = true;
   }
 
-  std::vector<float>& mapSpectrum(const std::vector<float>& in, const std::vector<float>& phase, float frameDt);
+  std::vector<float>& mapSpectrum(const DSP::ConstantQ::Kernels& cqt, const std::vector<float>& in,
+                                  const std::vector<float>& phase, float frameDt);
   void render() override;
 };
 
@@ -48,11 +49,12 @@ std::shared_ptr<WindowManager::VisualizerWindow> createVisualizer() {
 
 /**
  * @brief Map spectrum data to visualization format
+ * @param cqt Kernel set pinned for this frame
  * @param in Input spectrum data
  * @return Mapped spectrum data
  */
-std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>& in, const std::vector<float>& phase,
-                                                       float frameDt) {
+std::vector<float>& SpectrogramVisualizer::mapSpectrum(const DSP::ConstantQ::Kernels& cqt, const std::vector<float>& in,
+                                                       const std::vector<float>& phase, float frameDt) {
   static std::vector<float> spectrum;
   spectrum.assign(bounds.h, 0.0f);
 
@@ -86,7 +88,8 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
     return magVal * gain;
   };
 
-  if (!Config::options.spectrogram.iterative_reassignment) {
+  // Columns analysed before phase was requested carry none
+  if (!Config::options.spectrogram.iterative_reassignment || phase.size() != in.size()) {
     // Standard spectrogram mapping with interpolation
     for (size_t i = 0; i < spectrum.size(); ++i) {
       float normalized = static_cast<float>(i) / static_cast<float>(spectrum.size() - 1);
@@ -104,7 +107,7 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
 
       size_t bin1, bin2;
       if (useCqt) {
-        std::tie(bin1, bin2) = DSP::ConstantQ::find(target);
+        std::tie(bin1, bin2) = cqt.find(target);
       } else {
         bin1 = static_cast<size_t>(target / fullBinHz);
         bin2 = bin1 + 1;
@@ -113,8 +116,8 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
       if (bin1 < in.size()) {
         if (bin2 < in.size() && bin1 != bin2) {
           if (useCqt) {
-            float f1 = DSP::ConstantQ::frequencies[bin1];
-            float f2 = DSP::ConstantQ::frequencies[bin2];
+            float f1 = cqt.frequencies[bin1];
+            float f2 = cqt.frequencies[bin2];
             float frac = (target - f1) / std::max(f2 - f1, FLT_EPSILON);
             spectrum[i] = in[bin1] * (1.f - frac) + in[bin2] * frac;
           } else {
@@ -139,7 +142,9 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
     haveLastPhase = false;
   }
 
-  const size_t sourceBins = std::min(in.size(), phase.size());
+  // Columns analysed with the previous kernel set may have more bins than the pinned one
+  const size_t sourceBins =
+      std::min({in.size(), phase.size(), useCqt ? cqt.frequencies.size() : in.size()});
   const float safeDt = std::max(frameDt, 1e-4f);
   const float ampThreshold = powf(10.0f, Config::options.spectrogram.limits.min_db / 20.0f);
 
@@ -170,8 +175,7 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
     if (k > 0 && k + 1 < sourceBins && (in[k] < in[k - 1] || in[k] < in[k + 1]))
       continue;
 
-    float nominalFreq = useCqt ? (k < DSP::ConstantQ::frequencies.size() ? DSP::ConstantQ::frequencies[k] : 0.f)
-                               : static_cast<float>(k) * fullBinHz;
+    float nominalFreq = useCqt ? cqt.frequencies[k] : static_cast<float>(k) * fullBinHz;
     if (nominalFreq <= 0.f)
       continue;
 
@@ -190,9 +194,9 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
       float correctionHz = delta / (twoPi * safeDt);
 
       float bandwidthHz = fullBinHz;
-      if (useCqt && k > 0 && k + 1 < DSP::ConstantQ::frequencies.size()) {
-        float left = DSP::ConstantQ::frequencies[k] - DSP::ConstantQ::frequencies[k - 1];
-        float right = DSP::ConstantQ::frequencies[k + 1] - DSP::ConstantQ::frequencies[k];
+      if (useCqt && k > 0 && k + 1 < cqt.frequencies.size()) {
+        float left = cqt.frequencies[k] - cqt.frequencies[k - 1];
+        float right = cqt.frequencies[k + 1] - cqt.frequencies[k];
         bandwidthHz = 0.5f * (left + right);
       }
 
@@ -211,7 +215,7 @@ std::vector<float>& SpectrogramVisualizer::mapSpectrum(const std::vector<float>&
     float sum = wl + wc + wr;
     if (sum > FLT_EPSILON) {
       auto binToFreq = [&](size_t idx) {
-        return useCqt ? DSP::ConstantQ::frequencies[idx] : static_cast<float>(idx) * fullBinHz;
+        return useCqt ? cqt.frequencies[idx] : static_cast<float>(idx) * fullBinHz;
       };
       float centroidFreq = (binToFreq(l) * wl + binToFreq(center) * wc + binToFreq(r) * wr) / sum;
       reassignedFreq = clampFreq(0.5f * reassignedFreq + 0.5f * centroidFreq);
@@ -246,6 +250,10 @@ void SpectrogramVisualizer::render() {
 
   static size_t current = 0;
 
+  // Reassignment corrects frequencies from the phase advance between columns
+  if (Config::options.spectrogram.iterative_reassignment)
+    DSP::FFT::requestPhase();
+
   // Ensure current is within bounds when texture dimensions change
   if (current >= bounds.w)
     current = 0;
@@ -255,27 +263,47 @@ void SpectrogramVisualizer::render() {
   glColor4f(1.f, 1.f, 1.f, 1.f);
   glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
 
-  // Pace column emission so full texture width represents spectrogram.window seconds.
+  // Columns advance with audio time so the full texture width represents spectrogram.window seconds.
+  // Every queued analysis frame lands at its own position instead of repeating the latest spectrum.
   const size_t textureWidth = bounds.w;
-  const float interval =
-      textureWidth > 0 ? std::max(Config::options.spectrogram.window, 1e-3f) / static_cast<float>(textureWidth) : 0.0f;
-
-  static float columnAccumulator = 0.0f;
-  static float phaseDtAccumulator = 0.0f;
-  columnAccumulator += WindowManager::dt;
-  phaseDtAccumulator += WindowManager::dt;
-
-  size_t columnsToWrite = 0;
-  if (interval > FLT_EPSILON) {
-    columnsToWrite = static_cast<size_t>(columnAccumulator / interval);
-    if (columnsToWrite > 0)
-      columnAccumulator -= interval * static_cast<float>(columnsToWrite);
-  }
+  const float sampleRate = Config::options.audio.sample_rate;
+  const double framesPerColumn =
+      textureWidth > 0
+          ? std::max(Config::options.spectrogram.window, 1e-3f) * sampleRate / static_cast<double>(textureWidth)
+          : 0.0;
+
+  static DSP::FFT::Column column;
+  static double nextColumnFrame = -1.0;
+  static uint64_t lastFrame = 0;
+
+  // One kernel set for every column mapped this frame
+  const auto cqt = DSP::ConstantQ::current();
+
+  while (DSP::FFT::popColumn(column)) {
+    const float frameDt =
+        lastFrame != 0 && column.frame > lastFrame ? static_cast<float>(column.frame - lastFrame) / sampleRate : 0.f;
+    lastFrame = column.frame;
+    if (textureWidth == 0 || framesPerColumn <= 0.0)
+      continue;
+
+    // Resynchronise after a gap longer than the whole texture
+    const double frame = static_cast<double>(column.frame);
+    if (nextColumnFrame < 0.0 || frame - nextColumnFrame > framesPerColumn * static_cast<double>(textureWidth))
+      nextColumnFrame = frame;
 
-  if (textureWidth > 0 && columnsToWrite > 0) {
+    size_t columnsToWrite = 0;
+    while (nextColumnFrame <= frame) {
+      columnsToWrite++;
+      nextColumnFrame += framesPerColumn;
+    }
+
+    // Reassignment needs every frame for phase continuity, plain mapping only the ones that are drawn
+    if (columnsToWrite == 0 && !Config::options.spectrogram.iterative_reassignment)
+      continue;
+    std::vector<float>& spectrum = mapSpectrum(*cqt, column.magnitude, column.phase, std::max(frameDt, 1e-4f));
+    if (columnsToWrite == 0)
+      continue;
     columnsToWrite = std::min(columnsToWrite, textureWidth);
-    std::vector<float>& spectrum = mapSpectrum(DSP::fftMidRaw, DSP::fftMidPhase, std::max(phaseDtAccumulator, 1e-4f));
-    phaseDtAccumulator = 0.0f;
 
     // Prepare column data for rendering
     static std::vector<float> columnData;
@@ -30,6 +30,10 @@ class SpectrumAnalyzerVisualizer : public WindowManager::VisualizerWindow {
 public:
   std::vector<std::pair<float, float>> pointsMain;
   std::vector<std::pair<float, float>> pointsAlt;
+  std::vector<std::pair<float, float>> pointsPeakMain;
+  std::vector<std::pair<float, float>> pointsPeakAlt;
+  std::vector<std::pair<float, float>> pointsAverageMain;
+  std::vector<std::pair<float, float>> pointsAverageAlt;
   std::vector<float> energyCompensation;
 
   SpectrumAnalyzerVisualizer() {
@@ -51,11 +55,18 @@ std::shared_ptr<WindowManager::VisualizerWindow> createVisualizer() {
 
 float hzToMel(float f) { return 2595.0f * log10f(1.0f + f / 700.0f); }
 
+// Frequency of a CQT bin; spectra computed just before a kernel swap may have a different bin count
+float cqtFrequency(const DSP::ConstantQ::Kernels& cqt, size_t bin) {
+  if (cqt.frequencies.empty())
+    return 0.0f;
+  return cqt.frequencies[std::min(bin, cqt.frequencies.size() - 1)];
+}
+
 // Helper to map a bin index to an X coordinate
-float binToX(size_t bin, float width, float minFreq, float maxFreq, float logMin, float logMax, float melMin,
-             float melMax) {
+float binToX(const DSP::ConstantQ::Kernels& cqt, size_t bin, float width, float minFreq, float maxFreq, float logMin,
+             float logMax, float melMin, float melMax) {
   float f = Config::options.fft.cqt.enabled
-                ? DSP::ConstantQ::frequencies[bin]
+                ? cqtFrequency(cqt, bin)
                 : static_cast<float>(bin) * (Config::options.audio.sample_rate / Config::options.fft.size);
 
   if (Config::options.fft.frequency_scale == "log") {
@@ -71,17 +82,24 @@ float binToX(size_t bin, float width, float minFreq, float maxFreq, float logMin
 }
 
 void SpectrumAnalyzerVisualizer::render() {
+  // Sphere mode rotates bins by their phase
+  if (Config::options.fft.sphere.enabled && Config::options.phosphor.enabled)
+    DSP::FFT::requestPhase();
 
   // Choose between smoothed and raw FFT data
   const std::vector<float>& inMain = Config::options.fft.smoothing.enabled ? DSP::fftMid : DSP::fftMidRaw;
   const std::vector<float>& inAlt = Config::options.fft.smoothing.enabled ? DSP::fftSide : DSP::fftSideRaw;
 
+  // Pin the kernel set so every bin of this frame maps through the same frequencies
+  const auto cqt = DSP::ConstantQ::current();
+  const float pitch = DSP::Pitch::current().frequency;
+
   float minFreq;
   float maxFreq;
 
   if (Config::options.fft.cqt.enabled) {
-    minFreq = DSP::ConstantQ::frequencies.front();
-    maxFreq = DSP::ConstantQ::frequencies.back();
+    minFreq = cqt->frequencies.front();
+    maxFreq = cqt->frequencies.back();
   } else {
     minFreq = Config::options.audio.sample_rate / Config::options.fft.size;
     maxFreq = inMain.size() * (Config::options.audio.sample_rate / Config::options.fft.size);
@@ -154,6 +172,10 @@ void SpectrumAnalyzerVisualizer::render() {
   // Prepare point arrays
   pointsMain.clear();
   pointsAlt.clear();
+  pointsPeakMain.clear();
+  pointsPeakAlt.clear();
+  pointsAverageMain.clear();
+  pointsAverageAlt.clear();
   pointsMain.resize(inMain.size());
   // Optional per-point depth factors (used for shading in sphere mode)
   std::vector<float> depthsMain;
@@ -170,21 +192,19 @@ void SpectrumAnalyzerVisualizer::render() {
     // Align phases so the current main pitch has phase zero
     float refPhaseMid = 0.0f;
     bool haveRefPhase = false;
-    if (DSP::pitchDB > Config::options.audio.silence_threshold && !DSP::fftMidPhase.empty()) {
+    if (pitch > 0.0f && DSP::pitchDB > Config::options.audio.silence_threshold && !DSP::fftMidPhase.empty()) {
       size_t refIdx = 0;
       if (Config::options.fft.cqt.enabled) {
-        auto brk = DSP::ConstantQ::find(DSP::pitch);
-        size_t i0 =
-            std::min(brk.first, DSP::ConstantQ::frequencies.size() ? DSP::ConstantQ::frequencies.size() - 1 : 0);
-        size_t i1 =
-            std::min(brk.second, DSP::ConstantQ::frequencies.size() ? DSP::ConstantQ::frequencies.size() - 1 : 0);
-        float f0 = (i0 < DSP::ConstantQ::frequencies.size()) ? DSP::ConstantQ::frequencies[i0] : 0.0f;
-        float f1 = (i1 < DSP::ConstantQ::frequencies.size()) ? DSP::ConstantQ::frequencies[i1] : 0.0f;
-        refIdx = (std::fabs(f0 - DSP::pitch) <= std::fabs(f1 - DSP::pitch)) ? i0 : i1;
+        auto brk = cqt->find(pitch);
+        size_t i0 = std::min(brk.first, cqt->frequencies.size() ? cqt->frequencies.size() - 1 : 0);
+        size_t i1 = std::min(brk.second, cqt->frequencies.size() ? cqt->frequencies.size() - 1 : 0);
+        float f0 = (i0 < cqt->frequencies.size()) ? cqt->frequencies[i0] : 0.0f;
+        float f1 = (i1 < cqt->frequencies.size()) ? cqt->frequencies[i1] : 0.0f;
+        refIdx = (std::fabs(f0 - pitch) <= std::fabs(f1 - pitch)) ? i0 : i1;
       } else {
         size_t bins = inMain.size();
         float binHz = Config::options.audio.sample_rate / std::max(static_cast<float>(bins), FLT_EPSILON);
-        refIdx = static_cast<size_t>(roundf(DSP::pitch / std::max(binHz, FLT_EPSILON)));
+        refIdx = static_cast<size_t>(roundf(pitch / std::max(binHz, FLT_EPSILON)));
       }
       if (refIdx < DSP::fftMidPhase.size()) {
         refPhaseMid = DSP::fftMidPhase[refIdx];
@@ -202,10 +222,10 @@ void SpectrumAnalyzerVisualizer::render() {
 
     size_t maxBinMain;
     if (Config::options.fft.cqt.enabled) {
-      size_t limit = std::min(inMain.size(), DSP::ConstantQ::frequencies.size());
+      size_t limit = std::min(inMain.size(), cqt->frequencies.size());
       size_t k = 0;
       for (; k < limit; ++k) {
-        if (DSP::ConstantQ::frequencies[k] > fMax)
+        if (cqt->frequencies[k] > fMax)
           break;
       }
       maxBinMain = (k == 0) ? 0 : (k - 1);
@@ -220,7 +240,7 @@ void SpectrumAnalyzerVisualizer::render() {
     for (size_t bin = binOffset; bin <= maxBinMain; bin++) {
       float f;
       if (Config::options.fft.cqt.enabled)
-        f = DSP::ConstantQ::frequencies[bin];
+        f = cqtFrequency(*cqt, bin);
       else
         f = static_cast<float>(bin) * (Config::options.audio.sample_rate / Config::options.fft.size);
 
@@ -246,7 +266,7 @@ void SpectrumAnalyzerVisualizer::render() {
       // Rotate around Y-axis by phase aligned to main pitch (harmonic-locked)
       float phase = (bin < DSP::fftMidPhase.size()) ? DSP::fftMidPhase[bin] : 0.0f;
       if (haveRefPhase) {
-        float pitchHz = std::max(DSP::pitch, 1.0f);
+        float pitchHz = std::max(pitch, 1.0f);
         int harmonicIndex = std::max(1, static_cast<int>(roundf(f / pitchHz)));
         phase -= static_cast<float>(harmonicIndex) * refPhaseMid;
       }
@@ -302,9 +322,9 @@ void SpectrumAnalyzerVisualizer::render() {
              : static_cast<float>(bounds.w));
     static float prevX;
     for (size_t bin = binOffset; bin < inMain.size(); bin++) {
-      float x = binToX(bin, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
+      float x = binToX(*cqt, bin, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
       if (bin == binOffset) {
-        prevX = -binToX(bin + 1, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
+        prevX = -binToX(*cqt, bin + 1, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
       }
       if (Config::options.phosphor.enabled)
         energyCompensation[bin] = x - prevX;
@@ -312,7 +332,7 @@ void SpectrumAnalyzerVisualizer::render() {
 
       float f;
       if (Config::options.fft.cqt.enabled)
-        f = DSP::ConstantQ::frequencies[bin];
+        f = cqtFrequency(*cqt, bin);
       else
         f = static_cast<float>(bin) * (Config::options.audio.sample_rate / Config::options.fft.size);
 
@@ -349,10 +369,10 @@ void SpectrumAnalyzerVisualizer::render() {
       pointsAlt.resize(inAlt.size());
 
     for (size_t bin = binOffset; bin < inAlt.size() && !Config::options.phosphor.enabled; bin++) {
-      float x = binToX(bin, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
+      float x = binToX(*cqt, bin, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
       float f;
       if (Config::options.fft.cqt.enabled)
-        f = DSP::ConstantQ::frequencies[bin];
+        f = cqtFrequency(*cqt, bin);
       else
         f = static_cast<float>(bin) * (Config::options.audio.sample_rate / inAlt.size());
       float mag = inAlt[bin];
@@ -379,6 +399,49 @@ void SpectrumAnalyzerVisualizer::render() {
         break;
       }
     }
+
+    // Accumulator curves are computed on the FFT threads, only map them here
+    auto mapCurve = [&](const std::vector<float>& mags, std::vector<std::pair<float, float>>& points) {
+      points.reserve(mags.size());
+      for (size_t bin = binOffset; bin < mags.size(); bin++) {
+        float x = binToX(*cqt, bin, width, minFreq, maxFreq, logMin, logMax, melMin, melMax);
+        float f;
+        if (Config::options.fft.cqt.enabled)
+          f = cqtFrequency(*cqt, bin);
+        else
+          f = static_cast<float>(bin) * (Config::options.audio.sample_rate / Config::options.fft.size);
+        float k = Config::options.fft.slope / 20.f / log10f(2.f);
+        float mag = mags[bin] * powf(f * 1.0f / (440.0f * 2.0f), k);
+        float dB = 20.f * log10f(mag + FLT_EPSILON);
+        float y = (dB - Config::options.fft.limits.min_db) /
+                  (Config::options.fft.limits.max_db - Config::options.fft.limits.min_db) * height;
+        if (Config::options.fft.flip_x)
+          y = height - y;
+        switch (Config::options.fft.rotation) {
+        case Config::ROTATION_0:
+          points.push_back({x, y});
+          break;
+        case Config::ROTATION_90:
+          points.push_back({bounds.w - y, x});
+          break;
+        case Config::ROTATION_180:
+          points.push_back({bounds.w - x, bounds.h - y});
+          break;
+        case Config::ROTATION_270:
+          points.push_back({y, bounds.h - x});
+          break;
+        }
+      }
+    };
+
+    if (!Config::options.phosphor.enabled) {
+      const auto accMain = DSP::Accumulator::current(DSP::Accumulator::mid);
+      const auto accAlt = DSP::Accumulator::current(DSP::Accumulator::side);
+      mapCurve(accMain->peak, pointsPeakMain);
+      mapCurve(accMain->average, pointsAverageMain);
+      mapCurve(accAlt->peak, pointsPeakAlt);
+      mapCurve(accAlt->average, pointsAverageAlt);
+    }
   }
 
   // Choose rendering colors
@@ -493,7 +556,22 @@ void SpectrumAnalyzerVisualizer::render() {
     Graphics::Phosphor::render(this, pointsMain, true, color);
     draw();
   } else {
+    // Accumulator curves use their channel's color at reduced opacity
+    float peakColor[4], peakColorAlt[4], averageColor[4], averageColorAlt[4];
+    std::copy_n(color, 4, peakColor);
+    std::copy_n(color, 4, averageColor);
+    std::copy_n(colorAlt, 4, peakColorAlt);
+    std::copy_n(colorAlt, 4, averageColorAlt);
+    peakColor[3] *= 0.4f;
+    peakColorAlt[3] *= 0.4f;
+    averageColor[3] *= 0.7f;
+    averageColorAlt[3] *= 0.7f;
+
+    Graphics::drawLines(this, pointsPeakAlt, peakColorAlt);
+    Graphics::drawLines(this, pointsAverageAlt, averageColorAlt);
     Graphics::drawLines(this, pointsAlt, colorAlt);
+    Graphics::drawLines(this, pointsPeakMain, peakColor);
+    Graphics::drawLines(this, pointsAverageMain, averageColor);
     Graphics::drawLines(this, pointsMain, color);
   }
 
@@ -585,8 +663,8 @@ void SpectrumAnalyzerVisualizer::render() {
     dB += 20.f * log10f(gain);
 
     drawNoteInfo(freq, dB);
-  } else if (DSP::pitchDB > Config::options.audio.silence_threshold) {
-    drawNoteInfo(DSP::pitch, DSP::pitchDB);
+  } else if (pitch > 0.0f && DSP::pitchDB > Config::options.audio.silence_threshold) {
+    drawNoteInfo(pitch, DSP::pitchDB);
   }
 }
 
@@ -74,7 +74,7 @@ float VUVisualizer::scaleDB(float db) {
 void VUVisualizer::render() {
   WindowManager::setViewport(bounds);
 
-  float dB = 20.0f * log10(DSP::RMS::rms) + Config::options.vu.calibration_db;
+  float dB = 20.0f * log10(DSP::RMS::current()->mid) + Config::options.vu.calibration_db;
 
   if (Config::options.vu.style == "digital") {
     // Calculate layout positions
@@ -110,6 +110,18 @@ void VUVisualizer::render() {
       Graphics::drawLine(LABEL_WIDTH, y, LABEL_WIDTH + LABEL_LINE_LENGTH, y, Theme::colors.text, 1);
     }
 
+    // Draw the held peak of the louder channel as a marker on the same calibrated scale
+    const std::shared_ptr<const DSP::Peak::Levels> peak = DSP::Peak::current();
+    const float peakLevel = std::max(peak->left, peak->right);
+    const float peakDB = 20.0f * log10f(peakLevel) + Config::options.vu.calibration_db;
+    if (peakDB >= -20.0f) {
+      size_t peakY = bounds.h - (topHeight + (1.0f - scaleDB(std::min(peakDB, 3.0f))) * barHeight);
+      const float* peakColor = peakLevel >= DSP::Peak::clipLevel && Theme::colors.vu_clip[3] > FLT_EPSILON
+                                   ? Theme::colors.vu_clip
+                                   : Theme::colors.text;
+      Graphics::drawLine(vuBarX, peakY, vuBarX + VU_BAR_WIDTH, peakY, peakColor, 2);
+    }
+
     // Draw VU bar if value is valid
     if (dB < -20.0f)
       return;
@@ -70,6 +70,7 @@ void WaveformVisualizer::render() {
     std::array<float, 3> columnColorB = {baseColor[0], baseColor[1], baseColor[2]};
     if (Theme::colors.waveform_low[3] > FLT_EPSILON && Theme::colors.waveform_mid[3] > FLT_EPSILON &&
         Theme::colors.waveform_high[3] > FLT_EPSILON) {
+      const auto cqt = DSP::ConstantQ::current();
       auto computeTraceColor = [&](const std::vector<float>& fftData, std::array<float, 3>& outColor) {
         if (fftData.empty())
           return;
@@ -89,9 +90,9 @@ void WaveformVisualizer::render() {
         for (size_t i = 0; i < fftData.size(); ++i) {
           float freq = 0.0f;
           if (Config::options.fft.cqt.enabled) {
-            if (i >= DSP::ConstantQ::frequencies.size())
+            if (i >= cqt->frequencies.size())
               break;
-            freq = DSP::ConstantQ::frequencies[i];
+            freq = cqt->frequencies[i];
           } else {
             freq = static_cast<float>(i) * (Config::options.audio.sample_rate / std::max(1, Config::options.fft.size));
           }
@@ -139,8 +140,13 @@ void WaveformVisualizer::render() {
     static std::vector<float> columnData;
     columnData.resize(bounds.h * 4);
 
-    auto drawMinMaxEnvelopeColumn = [&](int rowMin, int rowMax, size_t startIndex, size_t sampleCount, bool secondary,
-                                        const float* color) {
+    // Snapshot the ring head once so all columns of this frame line up
+    const uint64_t head = DSP::ring.head();
+    const float* bufferMid = DSP::ring.mid().data();
+    const float* bufferSide = DSP::ring.side().data();
+
+    auto drawMinMaxEnvelopeColumn = [&](int rowMin, int rowMax, uint64_t startFrame, size_t sampleCount,
+                                        bool secondary, const float* color) {
       if (sampleCount == 0 || rowMax < rowMin)
         return;
 
@@ -148,9 +154,9 @@ void WaveformVisualizer::render() {
       float maxValue = -INFINITY;
 
       for (size_t i = 0; i < sampleCount; ++i) {
-        size_t idx = (startIndex + i) % DSP::bufferSize;
-        float mid = DSP::bufferMid[idx];
-        float side = DSP::bufferSide[idx];
+        size_t idx = DSP::ring.index(startFrame + i);
+        float mid = bufferMid[idx];
+        float side = bufferSide[idx];
 
         float value = mid;
         if (Config::options.waveform.mode != "mono" && Config::options.fft.mode == "leftright")
@@ -197,18 +203,16 @@ void WaveformVisualizer::render() {
         columnData[i * 4 + 3] = 1.0f;
       }
 
-      size_t endIndex = (DSP::writePos + DSP::bufferSize -
-                         (columnsToWrite * sampleCountPerColumn - ((col + 1) * sampleCountPerColumn))) %
-                        DSP::bufferSize;
-      size_t startIndex = (endIndex + DSP::bufferSize - sampleCountPerColumn) % DSP::bufferSize;
+      uint64_t endFrame = head - (columnsToWrite * sampleCountPerColumn - ((col + 1) * sampleCountPerColumn));
+      uint64_t startFrame = endFrame - sampleCountPerColumn;
 
       if (Config::options.waveform.mode != "mono") {
-        drawMinMaxEnvelopeColumn(static_cast<int>(bounds.h / 2), static_cast<int>(bounds.h - 1), startIndex,
+        drawMinMaxEnvelopeColumn(static_cast<int>(bounds.h / 2), static_cast<int>(bounds.h - 1), startFrame,
                                  sampleCountPerColumn, false, columnColorA.data());
-        drawMinMaxEnvelopeColumn(0, static_cast<int>(std::max<size_t>(bounds.h / 2, 1) - 1), startIndex,
+        drawMinMaxEnvelopeColumn(0, static_cast<int>(std::max<size_t>(bounds.h / 2, 1) - 1), startFrame,
                                  sampleCountPerColumn, true, columnColorB.data());
       } else {
-        drawMinMaxEnvelopeColumn(0, static_cast<int>(bounds.h - 1), startIndex, sampleCountPerColumn, false,
+        drawMinMaxEnvelopeColumn(0, static_cast<int>(bounds.h - 1), startFrame, sampleCountPerColumn, false,
                                  columnColorA.data());
       }
 
@@ -0,0 +1,119 @@
+/*
+ * Pulse Audio Visualizer
+ * Copyright (C) 2025 Beacroxx
+ * Copyright (C) 2025 Contributors (see CONTRIBUTORS.md)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/work_pool.hpp"
+
+namespace DSP {
+
+WorkPool::~WorkPool() { resize(0); }
+
+void WorkPool::resize(size_t workerCount) {
+  if (workerCount == workers.size())
+    return;
+
+  // Jobs in flight keep going: their callers finish whatever the retiring workers leave behind
+  for (auto& worker : workers)
+    worker.request_stop();
+  wake.notify_all();
+  workers.clear();
+
+  count.store(workerCount, std::memory_order_relaxed);
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; i++)
+    workers.emplace_back([this](std::stop_token stoken) { workerMain(stoken); });
+}
+
+void WorkPool::participate(Job& job, size_t slot) {
+  // Own range first
+  Range& own = job.ranges[slot];
+  for (size_t task; (task = own.next.fetch_add(1, std::memory_order_relaxed)) < own.end;) {
+    (*job.fn)(task);
+    job.done.fetch_add(1, std::memory_order_release);
+  }
+
+  // Then steal from the others, starting with the next slot to spread thieves out
+  for (size_t i = 1; i < job.participants; i++) {
+    Range& victim = job.ranges[(slot + i) % job.participants];
+    for (size_t task; (task = victim.next.fetch_add(1, std::memory_order_relaxed)) < victim.end;) {
+      (*job.fn)(task);
+      job.done.fetch_add(1, std::memory_order_release);
+    }
+  }
+}
+
+void WorkPool::run(size_t tasks, const std::function<void(size_t)>& fn) {
+  if (tasks == 0)
+    return;
+
+  auto job = std::make_shared<Job>();
+  job->fn = &fn;
+  job->tasks = tasks;
+  job->participants = std::min(size() + 1, tasks);
+  job->ranges = std::make_unique<Range[]>(job->participants);
+  for (size_t i = 0; i < job->participants; i++) {
+    job->ranges[i].next.store(tasks * i / job->participants, std::memory_order_relaxed);
+    job->ranges[i].end = tasks * (i + 1) / job->participants;
+  }
+
+  if (job->participants > 1) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      jobs.push_back(job);
+    }
+    wake.notify_all();
+  }
+
+  participate(*job, 0);
+
+  // Wait for tasks other participants are still executing
+  for (size_t done; (done = job->done.load(std::memory_order_acquire)) < tasks;)
+    job->done.wait(done, std::memory_order_acquire);
+
+  if (job->participants > 1) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::erase(jobs, job);
+  }
+}
+
+void WorkPool::workerMain(std::stop_token stoken) {
+  while (true) {
+    std::shared_ptr<Job> job;
+    size_t slot = 0;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      // Join the oldest job that still has an unclaimed slot. Slots are only claimed under the lock, so the
+      // predicate can stay side-effect free and the claim below cannot overshoot participants.
+      auto open = [&] {
+        auto it = std::find_if(jobs.begin(), jobs.end(), [](const auto& candidate) {
+          return candidate->joined.load(std::memory_order_relaxed) < candidate->participants;
+        });
+        return it == jobs.end() ? nullptr : *it;
+      };
+      if (!wake.wait(lock, stoken, [&] { return open() != nullptr; }))
+        return;
+      job = open();
+      slot = job->joined.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    participate(*job, slot);
+    job->done.notify_all();
+  }
+}
+
+} // namespace DSP
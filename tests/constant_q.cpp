@@ -0,0 +1,318 @@
+/*
+ * Pulse Audio Visualizer
+ * Copyright (C) 2025 Beacroxx
+ * Copyright (C) 2025 Contributors (see CONTRIBUTORS.md)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/include/config.hpp"
+#include "../src/include/dsp.hpp"
+
+#include <cstdio>
+#include <string_view>
+
+// Checks the alternative Constant Q engines against the direct compute() on the same kernel set.
+// Usage: constant_q_test <case>
+
+using namespace DSP;
+
+namespace {
+
+constexpr float sampleRate = 48000.f;
+constexpr int fftSize = 4096;
+
+ConstantQ::Settings makeSettings(const char* engine, const char* precision = "single") {
+  ConstantQ::Settings settings;
+  settings.binsPerOctave = 12;
+  settings.minFreq = 40.f;
+  settings.maxFreq = 16000.f;
+  settings.fftSize = fftSize;
+  settings.sampleRate = sampleRate;
+  settings.engine = engine;
+  settings.precision = precision;
+  settings.threads = 1;
+  return settings;
+}
+
+/**
+ * @brief Append frames of a sine to the mid channel, continuing from the frames already written
+ */
+void pushSine(float freq, float phase, size_t frames) {
+  const uint64_t start = ring.head();
+  ring.produce(frames, [=](float* mid, float* side, size_t offset, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      const double t = static_cast<double>(start + offset + i) / sampleRate;
+      mid[i] = static_cast<float>(0.5 * std::sin(2.0 * M_PI * freq * t + phase));
+      side[i] = 0.f;
+    }
+  });
+}
+
+/**
+ * @brief Append frames of white noise plus a few tones to the mid channel
+ */
+void pushBroadband(size_t frames) {
+  const uint64_t start = ring.head();
+  uint32_t seed = 12345;
+  ring.produce(frames, [start, &seed](float* mid, float* side, size_t offset, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      const double t = static_cast<double>(start + offset + i) / sampleRate;
+      seed = seed * 1664525u + 1013904223u;
+      const float noise = static_cast<float>(seed >> 8) / 16777216.f - 0.5f;
+      mid[i] = 0.1f * noise + static_cast<float>(0.2 * std::sin(2.0 * M_PI * 82.0 * t) +
+                                                 0.2 * std::sin(2.0 * M_PI * 997.0 * t + 1.0) +
+                                                 0.2 * std::sin(2.0 * M_PI * 9100.0 * t + 2.0));
+      side[i] = 0.f;
+    }
+  });
+}
+
+float phaseError(float a, float b) { return std::abs(std::remainder(a - b, 2.f * static_cast<float>(M_PI))); }
+
+/**
+ * @brief The sliding engine's phase must match compute() on the bins a tone falls into
+ */
+int checkSliding() {
+  const auto kernels = ConstantQ::build(makeSettings("sliding"));
+  int failures = 0;
+
+  for (float freq : {55.f, 440.f, 1234.f, 7000.f}) {
+    ring.resize(bufferSize * 2);
+    ConstantQ::Sliding state;
+    std::vector<float> out, phase, refOut, refPhase;
+
+    // First call seeds every bin, the later ones slide by a hop
+    pushSine(freq, 0.3f, fftSize * 3);
+    for (int hop = 0; hop < 4; hop++) {
+      if (hop > 0)
+        pushSine(freq, 0.3f, 317);
+      const uint64_t end = ring.head();
+      ConstantQ::computeSliding(*kernels, state, end, 1.f, 0.f, out, phase);
+      ConstantQ::compute(*kernels, ring.mid(), ring.side(), end, 1.f, 0.f, refOut, refPhase);
+      if (out.size() != kernels->bins || refOut.size() != kernels->bins) {
+        std::fprintf(stderr, "sliding: no output at %.0f Hz\n", freq);
+        return 1;
+      }
+
+      const auto [lo, hi] = kernels->find(freq);
+      for (size_t k = lo; k <= hi; k++) {
+        const float error = phaseError(phase[k], refPhase[k]);
+        if (error > 0.02f) {
+          std::fprintf(stderr, "sliding: bin %zu (%.1f Hz) hop %d phase %.3f, compute() %.3f\n", k,
+                       kernels->frequencies[k], hop, phase[k], refPhase[k]);
+          failures++;
+        }
+      }
+    }
+  }
+  return failures ? 1 : 0;
+}
+
+/**
+ * @brief compute() with the fp16 kernel copies must stay within the fp16 rounding of the fp32 kernels
+ */
+int checkHalf() {
+  const auto single = ConstantQ::build(makeSettings("direct", "single"));
+  const auto half = ConstantQ::build(makeSettings("direct", "half"));
+  if (half->halfReals.size() != half->bins || !single->halfReals.empty()) {
+    std::fprintf(stderr, "half: kernel copies missing\n");
+    return 1;
+  }
+
+  ring.resize(bufferSize * 2);
+  pushBroadband(fftSize * 3);
+  const uint64_t end = ring.head();
+  std::vector<float> out, phase, refOut, refPhase;
+  ConstantQ::compute(*half, ring.mid(), ring.side(), end, 1.f, 0.f, out, phase);
+  ConstantQ::compute(*single, ring.mid(), ring.side(), end, 1.f, 0.f, refOut, refPhase);
+
+  // fp16 keeps 11 significant bits, so the error scales with the input rather than each bin's output
+  int failures = 0;
+  const float peak = *std::max_element(refOut.begin(), refOut.end());
+  for (size_t k = 0; k < single->bins; k++) {
+    if (std::abs(out[k] - refOut[k]) > 1e-3f * peak) {
+      std::fprintf(stderr, "half: bin %zu (%.1f Hz) magnitude %g, fp32 %g\n", k, single->frequencies[k], out[k],
+                   refOut[k]);
+      failures++;
+    }
+    if (refOut[k] > 0.1f * peak && phaseError(phase[k], refPhase[k]) > 1e-3f) {
+      std::fprintf(stderr, "half: bin %zu (%.1f Hz) phase %.4f, fp32 %.4f\n", k, single->frequencies[k], phase[k],
+                   refPhase[k]);
+      failures++;
+    }
+  }
+  return failures ? 1 : 0;
+}
+
+/**
+ * @brief The folded kernels must give what compute() gives with the full ones, down to the longest bins
+ */
+int checkSymmetric() {
+  const auto kernels = ConstantQ::build(makeSettings("symmetric"));
+  if (kernels->lengths.front() != fftSize + 1) {
+    std::fprintf(stderr, "symmetric: lowest bin is %zu taps, expected the clamped %d\n", kernels->lengths.front(),
+                 fftSize + 1);
+    return 1;
+  }
+
+  ring.resize(bufferSize * 2);
+  pushBroadband(fftSize * 3);
+  const uint64_t end = ring.head();
+  std::vector<float> out, phase, refOut, refPhase;
+  if (!ConstantQ::computeSymmetric(*kernels, end, 1.f, 0.f, out, phase)) {
+    std::fprintf(stderr, "symmetric: no output\n");
+    return 1;
+  }
+  ConstantQ::compute(*kernels, ring.mid(), ring.side(), end, 1.f, 0.f, refOut, refPhase);
+
+  // Only the incremental phase of the full kernels breaks their symmetry, by float rounding
+  int failures = 0;
+  const float peak = *std::max_element(refOut.begin(), refOut.end());
+  for (size_t k = 0; k < kernels->bins; k++) {
+    if (std::abs(out[k] - refOut[k]) > 1e-3f * peak) {
+      std::fprintf(stderr, "symmetric: bin %zu (%.1f Hz) magnitude %g, compute() %g\n", k,
+                   kernels->frequencies[k], out[k], refOut[k]);
+      failures++;
+    }
+    if (refOut[k] > 0.1f * peak && phaseError(phase[k], refPhase[k]) > 1e-3f) {
+      std::fprintf(stderr, "symmetric: bin %zu (%.1f Hz) phase %.4f, compute() %.4f\n", k, kernels->frequencies[k],
+                   phase[k], refPhase[k]);
+      failures++;
+    }
+  }
+  return failures ? 1 : 0;
+}
+
+/**
+ * @brief One transform with the sparse kernels must give what compute() gives with the dense ones
+ */
+int checkSparse() {
+  // computeSparse runs on the side channel's plan, sized by fft.size like in the app
+  Config::options.fft.size = fftSize;
+  Config::options.fft.planner = "estimate";
+  FFT::init();
+
+  const auto kernels = ConstantQ::build(makeSettings("sparse"));
+  ring.resize(bufferSize * 2);
+  pushBroadband(fftSize * 3);
+  const uint64_t end = ring.head();
+  std::vector<float> out, phase, refOut, refPhase;
+  bool computed;
+  {
+    std::lock_guard<std::mutex> lock(FFT::mutexSide);
+    computed = ConstantQ::computeSparse(*kernels, end, 1.f, 0.f, FFT::side, FFT::inSide, FFT::outSide, out, phase);
+  }
+  FFT::cleanup();
+  if (!computed) {
+    std::fprintf(stderr, "sparse: no output\n");
+    return 1;
+  }
+  ConstantQ::compute(*kernels, ring.mid(), ring.side(), end, 1.f, 0.f, refOut, refPhase);
+
+  // Kernel spectra are cut at sparseThreshold of their peak, which bounds the error by the input level; the
+  // phase is only compared on the strong bins, where a kernel off by one sample already shows
+  int failures = 0;
+  const float peak = *std::max_element(refOut.begin(), refOut.end());
+  for (size_t k = 0; k < kernels->bins; k++) {
+    if (std::abs(out[k] - refOut[k]) > 1e-2f * peak) {
+      std::fprintf(stderr, "sparse: bin %zu (%.1f Hz) magnitude %g, compute() %g\n", k, kernels->frequencies[k],
+                   out[k], refOut[k]);
+      failures++;
+    }
+    if (refOut[k] > 0.3f * peak && phaseError(phase[k], refPhase[k]) > 5e-3f) {
+      std::fprintf(stderr, "sparse: bin %zu (%.1f Hz) phase %.4f, compute() %.4f\n", k, kernels->frequencies[k],
+                   phase[k], refPhase[k]);
+      failures++;
+    }
+  }
+  return failures ? 1 : 0;
+}
+
+/**
+ * @brief The decimated octaves must measure steady tones like compute() does at the full rate
+ */
+int checkMultirate() {
+  // The multirate set holds the lower octaves' kernels at their decimated rates, compute() needs full-rate ones
+  const auto kernels = ConstantQ::build(makeSettings("multirate"));
+  const auto direct = ConstantQ::build(makeSettings("direct"));
+  if (kernels->levelCount < 2 || direct->bins != kernels->bins) {
+    std::fprintf(stderr, "multirate: %d levels for %zu bins, direct has %zu\n", kernels->levelCount, kernels->bins,
+                 direct->bins);
+    return 1;
+  }
+  ring.resize(bufferSize * 2);
+
+  // Steady tones across the octaves: the half-band delay of the lower ones shifts their phase, not their level
+  const float tones[] = {55.f, 233.f, 880.f, 3100.f, 11000.f};
+  const auto pushTones = [&tones](size_t frames) {
+    const uint64_t start = ring.head();
+    ring.produce(frames, [start, &tones](float* mid, float* side, size_t offset, size_t len) {
+      for (size_t i = 0; i < len; i++) {
+        const double t = static_cast<double>(start + offset + i) / sampleRate;
+        double sum = 0.0;
+        for (float freq : tones)
+          sum += 0.15 * std::sin(2.0 * M_PI * freq * t + freq);
+        mid[i] = static_cast<float>(sum);
+        side[i] = 0.f;
+      }
+    });
+  };
+
+  // The first call seeds the decimation chain with the last window, the second one runs on settled filters
+  ConstantQ::Multirate state;
+  std::vector<float> out, phase, refOut, refPhase;
+  pushTones(fftSize * 3);
+  ConstantQ::computeMultirate(*kernels, state, ring.head(), 1.f, 0.f, out, phase);
+  pushTones(fftSize * 3 / 2);
+  const uint64_t end = ring.head();
+  out.clear();
+  ConstantQ::computeMultirate(*kernels, state, end, 1.f, 0.f, out, phase);
+  if (out.size() != kernels->bins) {
+    std::fprintf(stderr, "multirate: no output\n");
+    return 1;
+  }
+  ConstantQ::compute(*direct, ring.mid(), ring.side(), end, 1.f, 0.f, refOut, refPhase);
+
+  // Half-band ripple and the shorter decimated kernels bound the error by the input level
+  int failures = 0;
+  const float peak = *std::max_element(refOut.begin(), refOut.end());
+  for (size_t k = 0; k < kernels->bins; k++) {
+    if (std::abs(out[k] - refOut[k]) > 1e-2f * peak) {
+      std::fprintf(stderr, "multirate: bin %zu (%.1f Hz) magnitude %g, compute() %g\n", k, kernels->frequencies[k],
+                   out[k], refOut[k]);
+      failures++;
+    }
+  }
+  return failures ? 1 : 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::string_view name = argc > 1 ? argv[1] : "";
+  if (name == "sliding")
+    return checkSliding();
+  if (name == "half")
+    return checkHalf();
+  if (name == "symmetric")
+    return checkSymmetric();
+  if (name == "sparse")
+    return checkSparse();
+  if (name == "multirate")
+    return checkMultirate();
+
+  std::fprintf(stderr, "unknown case '%.*s'\n", static_cast<int>(name.size()), name.data());
+  return 2;
+}
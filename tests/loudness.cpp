@@ -0,0 +1,178 @@
+/*
+ * Pulse Audio Visualizer
+ * Copyright (C) 2025 Beacroxx
+ * Copyright (C) 2025 Contributors (see CONTRIBUTORS.md)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../src/include/dsp.hpp"
+
+#include <cstdio>
+#include <initializer_list>
+#include <string_view>
+
+// Feeds the native loudness meter the synthetic signals of EBU Tech 3341 and 3342.
+// Usage: loudness_test <case>
+
+using namespace DSP;
+
+namespace {
+
+constexpr float sampleRate = 48000.f;
+
+// Tones fade in over 20 ms, a hard onset rings past full scale once interpolated
+constexpr double fadeSeconds = 0.02;
+
+double tone(float freq, float phase, uint64_t t) {
+  const double fade = std::min(1.0, static_cast<double>(t) / (fadeSeconds * sampleRate));
+  return fade * std::sin(2.0 * M_PI * freq * static_cast<double>(t) / sampleRate + phase);
+}
+
+struct Segment {
+  float dbfs;
+  float seconds;
+};
+
+/**
+ * @brief Feed a stereo sine through segments of constant level, in blocks like the ring delivers them
+ */
+void feed(LUFS::Meter& meter, float freq, std::initializer_list<Segment> segments, float phase = 0.f) {
+  constexpr size_t chunk = 1024;
+  std::vector<float> left(chunk), right(chunk);
+  uint64_t t = 0;
+  for (const Segment& segment : segments) {
+    const double amplitude = std::pow(10.0, segment.dbfs / 20.0);
+    const size_t frames = static_cast<size_t>(std::lround(segment.seconds * sampleRate));
+    for (size_t done = 0; done < frames;) {
+      const size_t len = std::min(chunk, frames - done);
+      for (size_t i = 0; i < len; i++, t++) {
+        left[i] = static_cast<float>(amplitude * tone(freq, phase, t));
+        right[i] = left[i];
+      }
+      meter.process(left.data(), right.data(), len);
+      done += len;
+    }
+  }
+}
+
+bool expect(const char* what, float value, float expected, float below, float above) {
+  if (value >= expected - below && value <= expected + above)
+    return true;
+  std::fprintf(stderr, "%s: %.2f, expected %.1f (-%.1f/+%.1f)\n", what, value, expected, below, above);
+  return false;
+}
+
+/**
+ * @brief EBU Tech 3341 cases 1-5: momentary, short-term and integrated loudness within +-0.1 LU
+ */
+int check3341() {
+  static LUFS::Meter meter;
+  bool ok = true;
+
+  for (float level : {-23.f, -33.f}) {
+    meter.init(sampleRate);
+    feed(meter, 1000.f, {{level, 20.f}});
+    const LUFS::Measurement m = meter.measure();
+    ok &= expect("3341 steady momentary", m.momentary, level, 0.1f, 0.1f);
+    ok &= expect("3341 steady short-term", m.shortterm, level, 0.1f, 0.1f);
+    ok &= expect("3341 steady integrated", m.integrated, level, 0.1f, 0.1f);
+  }
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-36.f, 10.f}, {-23.f, 60.f}, {-36.f, 10.f}});
+  ok &= expect("3341 case 3 integrated", meter.measure().integrated, -23.f, 0.1f, 0.1f);
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-72.f, 10.f}, {-36.f, 10.f}, {-23.f, 60.f}, {-36.f, 10.f}, {-72.f, 10.f}});
+  ok &= expect("3341 case 4 integrated", meter.measure().integrated, -23.f, 0.1f, 0.1f);
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-26.f, 20.f}, {-20.f, 20.1f}, {-26.f, 20.f}});
+  ok &= expect("3341 case 5 integrated", meter.measure().integrated, -23.f, 0.1f, 0.1f);
+
+  return ok ? 0 : 1;
+}
+
+/**
+ * @brief EBU Tech 3342 cases 1-4: loudness range within +-1 LU
+ */
+int check3342() {
+  static LUFS::Meter meter;
+  bool ok = true;
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-20.f, 20.f}, {-30.f, 20.f}});
+  ok &= expect("3342 case 1 range", meter.measure().range, 10.f, 1.f, 1.f);
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-20.f, 20.f}, {-15.f, 20.f}});
+  ok &= expect("3342 case 2 range", meter.measure().range, 5.f, 1.f, 1.f);
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-40.f, 20.f}, {-20.f, 20.f}});
+  ok &= expect("3342 case 3 range", meter.measure().range, 20.f, 1.f, 1.f);
+
+  meter.init(sampleRate);
+  feed(meter, 1000.f, {{-50.f, 20.f}, {-35.f, 20.f}, {-20.f, 20.f}, {-35.f, 20.f}, {-50.f, 20.f}});
+  ok &= expect("3342 case 4 range", meter.measure().range, 15.f, 1.f, 1.f);
+
+  return ok ? 0 : 1;
+}
+
+/**
+ * @brief True peak of full-scale tones whose samples miss the crest, within +0.2/-0.4 dB (EBU Tech 3341)
+ */
+int checkTruePeak() {
+  bool ok = true;
+
+  // fs / 4 at 45 degrees samples at +-0.707, fs / 6 at 0 degrees at +-0.866
+  for (auto [freq, phase] : {std::pair {sampleRate / 4.f, 0.25f * static_cast<float>(M_PI)},
+                             std::pair {sampleRate / 6.f, 0.f}}) {
+    TruePeak::Interpolator interpolator;
+    interpolator.init(TruePeak::factorFor(sampleRate));
+    std::vector<float> left(4800), right(4800);
+    for (size_t i = 0; i < left.size(); i++) {
+      left[i] = static_cast<float>(tone(freq, phase, i));
+      right[i] = 0.5f * left[i];
+    }
+    float peakLeft = 0.f, peakRight = 0.f;
+    interpolator.process(left.data(), right.data(), left.size(), peakLeft, peakRight);
+    ok &= expect("interpolated left", 20.f * std::log10(peakLeft), 0.f, 0.4f, 0.2f);
+    ok &= expect("interpolated right", 20.f * std::log10(peakRight), -6.02f, 0.4f, 0.2f);
+
+    static LUFS::Meter meter;
+    meter.init(sampleRate);
+    feed(meter, freq, {{0.f, 1.f}}, phase);
+    const LUFS::Measurement m = meter.measure();
+    ok &= expect("meter true peak", std::max(m.truePeak[0], m.truePeak[1]), 0.f, 0.4f, 0.2f);
+  }
+
+  return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const std::string_view name = argc > 1 ? argv[1] : "";
+  if (name == "3341")
+    return check3341();
+  if (name == "3342")
+    return check3342();
+  if (name == "truepeak")
+    return checkTruePeak();
+
+  std::fprintf(stderr, "unknown case '%.*s'\n", static_cast<int>(name.size()), name.data());
+  return 2;
+}
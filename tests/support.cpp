@@ -0,0 +1,36 @@
+/*
+ * Pulse Audio Visualizer
+ * Copyright (C) 2025 Beacroxx
+ * Copyright (C) 2025 Contributors (see CONTRIBUTORS.md)
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Globals main.cpp provides to the rest of the program, for the test executables that link without it
+
+#include "../src/include/common.hpp"
+
+namespace CmdlineArgs {
+bool debug = false;
+bool help = false;
+#ifdef _WIN32
+bool console = false;
+#endif
+} // namespace CmdlineArgs
+
+std::string expandUserPath(const std::string& path) { return path; }
+
+void reconfigure() {}
+
+Wakeup mainWake;